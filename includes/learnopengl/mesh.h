@@ -10,6 +10,11 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <utility>
 using namespace std;
 
 #define MAX_BONE_INFLUENCE 4
@@ -36,6 +41,39 @@ struct Vertex {
     glm::vec3 Color;
 };
 
+// ëרõĽջƶ㣨20ֽڣɫֻȡλáߺɫ
+// Ȼ޸ Vertexϴʱٴɸøʽ
+struct StockVertex {
+    glm::vec3 Position;
+    uint32_t Normal;    // GL_INT_2_10_10_10_REVΪ10λзŹһ
+    uint8_t Color[4];   // RGBA8һ
+};
+
+// ԴеĶʽ
+enum class VertexLayout {
+    Full,   //  Vertex
+    Stock,  // StockVertex
+};
+
+//  [-1, 1] ΧķߴΪ 10:10:10:2 зŹһw Ϊ0
+inline uint32_t packNormal2_10_10_10(const glm::vec3& normal)
+{
+    auto packComponent = [](float value) {
+        int quantized = static_cast<int>(std::round(glm::clamp(value, -1.0f, 1.0f) * 511.0f));
+        return static_cast<uint32_t>(quantized) & 0x3FFu;
+    };
+    return packComponent(normal.x) | (packComponent(normal.y) << 10) | (packComponent(normal.z) << 20);
+}
+
+inline void packStockVertex(const Vertex& vertex, StockVertex& packed)
+{
+    packed.Position = vertex.Position;
+    packed.Normal = packNormal2_10_10_10(vertex.Normal);
+    for (int i = 0; i < 3; ++i)
+        packed.Color[i] = static_cast<uint8_t>(std::round(glm::clamp(vertex.Color[i], 0.0f, 1.0f) * 255.0f));
+    packed.Color[3] = 255;
+}
+
 struct Texture {
     unsigned int id;
     string type;    // 
@@ -48,14 +86,18 @@ public:
     vector<Vertex>       vertices;
     vector<unsigned int> indices;
     vector<Texture>      textures;
-    unsigned int VAO;
+    unsigned int VAO = 0;
 
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    // layout ΪԴеĶʽëʹýյ VertexLayout::Stock
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures,
+         VertexLayout layout = VertexLayout::Full)
     {
-        this->vertices = vertices;
-        this->indices = indices;
-        this->textures = textures;
+        // ֵƶߴʱʱ񲻻ᱻ
+        this->vertices = std::move(vertices);
+        this->indices = std::move(indices);
+        this->textures = std::move(textures);
+        this->layout = layout;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
         setupMesh();
@@ -127,7 +169,20 @@ public:
         // 񼸺壬VAOʹ
         // draw mesh
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+        if (streaming)
+        {
+            // ʽģʽͨ basevertex ѡǰ򣬲ڻ֮դ
+            // ´дǰȴGPU
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0,
+                                     static_cast<GLint>(streamRegion * vertices.size()));
+            if (streamFences[streamRegion])
+                glDeleteSync(streamFences[streamRegion]);
+            streamFences[streamRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        else
+        {
+            glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+        }
         glBindVertexArray(0);
 
         // ָ״̬
@@ -137,18 +192,269 @@ public:
 
     // New method to update the VBO with modified vertex data
     void updateVertexBuffer() {
+        if (VAO == 0) {
+            clearDirtyVertices(); // ûԴ滺壨޴ģʽ
+            return;
+        }
+        if (streaming) {
+            // ɱ洢 glBufferSubData д룬Ǻʽд
+            markVerticesDirty(0, vertices.size());
+            streamDirtyVertices();
+            return;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        uploadVertexRange(0, vertices.size());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        clearDirtyVertices();
+    }
+
+    VertexLayout getVertexLayout() const { return layout; }
+    // Դÿֽ
+    size_t gpuVertexSize() const { return layout == VertexLayout::Stock ? sizeof(StockVertex) : sizeof(Vertex); }
+
+    // ҳλͼÿ DIRTY_PAGE_VERTICES Ϊһҳ޸Ķҳ
+    // uploadDirtyVertices() ֻϴǵҳڵҳϲΪһ glBufferSubData
+    static constexpr size_t DIRTY_PAGE_VERTICES = 64;
+
+    void markVertexDirty(size_t index) {
+        size_t page = index / DIRTY_PAGE_VERTICES;
+        if (dirtyPages.empty()) {
+            dirtyPages.assign((pageCount() + 63) / 64, 0);
+        }
+        dirtyPages[page >> 6] |= uint64_t(1) << (page & 63);
+        hasDirtyPages = true;
+    }
+
+    // ± [first, first + count) Ķ
+    void markVerticesDirty(size_t first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        size_t lastPage = (first + count - 1) / DIRTY_PAGE_VERTICES;
+        for (size_t page = first / DIRTY_PAGE_VERTICES; page <= lastPage; ++page) {
+            markVertexDirty(page * DIRTY_PAGE_VERTICES);
+        }
+    }
+
+    bool hasDirtyVertices() const { return hasDirtyPages; }
+
+    // ÿҳ fn(begin, end)Ϊ± [begin, end)
+    template <typename RangeFn>
+    void forEachDirtyRange(RangeFn&& fn) const {
+        if (!hasDirtyPages) {
+            return;
+        }
+        const size_t pages = pageCount();
+        size_t page = 0;
+        while (page < pages) {
+            if ((page & 63) == 0 && dirtyPages[page >> 6] == 0) {
+                page += 64; // ֶǸɾҳ
+                continue;
+            }
+            if (!isPageDirty(page)) {
+                ++page;
+                continue;
+            }
+            size_t firstPage = page;
+            while (page < pages && isPageDirty(page)) {
+                ++page;
+            }
+            fn(firstPage * DIRTY_PAGE_VERTICES, (std::min)(page * DIRTY_PAGE_VERTICES, vertices.size()));
+        }
+    }
+
+    // ҳдVBOǣϴֽûҳʱOpenGL
+    size_t uploadDirtyVertices() {
+        if (!hasDirtyPages) {
+            return 0;
+        }
+        if (VAO == 0) {
+            clearDirtyVertices(); // ûԴ滺壨޴ģʽ
+            return 0;
+        }
+        if (streaming) {
+            return streamDirtyVertices();
+        }
+        size_t uploadedBytes = 0;
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), &vertices[0]);
+        forEachDirtyRange([&](size_t begin, size_t end) {
+            uploadVertexRange(begin, end);
+            uploadedBytes += (end - begin) * gpuVertexSize();
+        });
         glBindBuffer(GL_ARRAY_BUFFER, 0);
+        clearDirtyVertices();
+        return uploadedBytes;
     }
 
+    void clearDirtyVertices() {
+        std::fill(dirtyPages.begin(), dirtyPages.end(), 0);
+        hasDirtyPages = false;
+    }
+
+    // ־ӳʽģʽ glBufferStorage СĲɱVBO
+    //  GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT פӳ䡣ÿϴֻһ
+    // ȴդҳֱдӳڴ棬û˵ĿҲȴʹõ
+    // Ҫ OpenGL 4.4  GL_ARB_buffer_storageglBufferStorage Ѽأ֧ʱfalseԭķʽ
+    static constexpr int STREAM_REGIONS = 3;
+
+    bool enableStreaming() {
+        if (streaming || glBufferStorage == nullptr || vertices.empty())
+            return false;
+
+        const size_t regionBytes = vertices.size() * gpuVertexSize();
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        unsigned int streamVBO;
+        glGenBuffers(1, &streamVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, streamVBO);
+        glBufferStorage(GL_ARRAY_BUFFER, regionBytes * STREAM_REGIONS, nullptr, flags);
+        void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, regionBytes * STREAM_REGIONS, flags);
+        if (mapped == nullptr)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &streamVBO);
+            return false;
+        }
+        streamMapped = static_cast<char*>(mapped);
+        for (int region = 0; region < STREAM_REGIONS; ++region)
+            writeGpuVertices(streamMapped + region * regionBytes, 0, vertices.size());
+
+        // ԸΪָµĻ壬ͬһԣʱ basevertex ƫ
+        glBindVertexArray(VAO);
+        setupVertexAttributes();
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &VBO);
+        VBO = streamVBO;
+
+        streaming = true;
+        streamRegion = 0;
+        for (int region = 0; region < STREAM_REGIONS; ++region)
+        {
+            streamFences[region] = nullptr;
+            streamPendingPages[region].assign(dirtyPages.size(), 0);
+        }
+        return true;
+    }
+
+    bool isStreaming() const { return streaming; }
+
 private:
     // render data 
     unsigned int VBO, EBO;
 
+    vector<uint64_t> dirtyPages;  // ÿһλӦһҳ
+    bool hasDirtyPages = false;
+
+    size_t pageCount() const { return (vertices.size() + DIRTY_PAGE_VERTICES - 1) / DIRTY_PAGE_VERTICES; }
+    bool isPageDirty(size_t page) const { return (dirtyPages[page >> 6] >> (page & 63)) & 1; }
+
+    VertexLayout layout = VertexLayout::Full;
+    vector<StockVertex> stockStaging; // ոʽϴʱĴ
+
+    // ± [begin, end) Ķ㰴Դʽд dst
+    void writeGpuVertices(void* dst, size_t begin, size_t end) const
+    {
+        if (layout == VertexLayout::Stock)
+        {
+            StockVertex* packed = static_cast<StockVertex*>(dst);
+            for (size_t i = begin; i < end; ++i)
+                packStockVertex(vertices[i], packed[i - begin]);
+        }
+        else
+        {
+            memcpy(dst, &vertices[begin], (end - begin) * sizeof(Vertex));
+        }
+    }
+
+    //  glBufferSubData ϴ± [begin, end) Ķ㣬ǰVBO
+    void uploadVertexRange(size_t begin, size_t end)
+    {
+        if (layout == VertexLayout::Stock)
+        {
+            stockStaging.resize(end - begin);
+            writeGpuVertices(stockStaging.data(), begin, end);
+            glBufferSubData(GL_ARRAY_BUFFER, begin * sizeof(StockVertex), (end - begin) * sizeof(StockVertex), stockStaging.data());
+        }
+        else
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, begin * sizeof(Vertex), (end - begin) * sizeof(Vertex), &vertices[begin]);
+        }
+    }
+
+    // ʽģʽ״̬
+    bool streaming = false;
+    int streamRegion = 0;                               // ǰڻƵ
+    char* streamMapped = nullptr;                       // VBOӳַ
+    GLsync streamFences[STREAM_REGIONS] = {};           // һζȡĻ֮դ
+    vector<uint64_t> streamPendingPages[STREAM_REGIONS]; // δдҳ
+
+    // ҳϲԵĴдλͼлһдĴдҳдֽ
+    size_t streamDirtyVertices()
+    {
+        for (int region = 0; region < STREAM_REGIONS; ++region)
+        {
+            vector<uint64_t>& pending = streamPendingPages[region];
+            pending.resize(dirtyPages.size(), 0);
+            for (size_t word = 0; word < dirtyPages.size(); ++word)
+                pending[word] |= dirtyPages[word];
+        }
+        clearDirtyVertices();
+
+        streamRegion = (streamRegion + 1) % STREAM_REGIONS;
+        waitForStreamRegion(streamRegion);
+
+        vector<uint64_t>& pending = streamPendingPages[streamRegion];
+        const size_t vertexSize = gpuVertexSize();
+        char* regionBase = streamMapped + streamRegion * vertices.size() * vertexSize;
+        const size_t pages = pageCount();
+        size_t writtenBytes = 0;
+        size_t page = 0;
+        while (page < pages)
+        {
+            if ((page & 63) == 0 && pending[page >> 6] == 0)
+            {
+                page += 64;
+                continue;
+            }
+            if (!((pending[page >> 6] >> (page & 63)) & 1))
+            {
+                ++page;
+                continue;
+            }
+            size_t firstPage = page;
+            while (page < pages && ((pending[page >> 6] >> (page & 63)) & 1))
+                ++page;
+            size_t begin = firstPage * DIRTY_PAGE_VERTICES;
+            size_t end = (std::min)(page * DIRTY_PAGE_VERTICES, vertices.size());
+            writeGpuVertices(regionBase + begin * vertexSize, begin, end);
+            writtenBytes += (end - begin) * vertexSize;
+        }
+        std::fill(pending.begin(), pending.end(), 0);
+        return writtenBytes;
+    }
+
+    void waitForStreamRegion(int region)
+    {
+        GLsync fence = streamFences[region];
+        if (!fence)
+            return;
+        for (;;)
+        {
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                break;
+        }
+        glDeleteSync(fence);
+        streamFences[region] = nullptr;
+    }
+
     // initializes all the buffer objects/arrays
     void setupMesh()
     {
+        // ûOpenGLʱ޴ģʽֻCPU˵ĶݣVAO Ϊ0
+        if (glGenVertexArrays == nullptr)
+            return;
+
         // create buffers/arraysVAOVBOEBOID
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -158,12 +464,40 @@ private:
         // load data into vertex buffersVBOԴ棬ض
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         // Change to GL_DYNAMIC_DRAW for frequent updates
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_DYNAMIC_DRAW);  
+        if (layout == VertexLayout::Stock)
+        {
+            stockStaging.resize(vertices.size());
+            writeGpuVertices(stockStaging.data(), 0, vertices.size());
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(StockVertex), stockStaging.data(), GL_DYNAMIC_DRAW);
+        }
+        else
+        {
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_DYNAMIC_DRAW);  
+        }
 
         // EBOԴ棬
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
+        setupVertexAttributes();
+        // VAO
+        glBindVertexArray(0);
+    }
+
+    // õǰ󶨵VAOĶԣԵǰ󶨵 GL_ARRAY_BUFFER
+    void setupVertexAttributes()
+    {
+        if (layout == VertexLayout::Stock)
+        {
+            // ոʽֻṩɫõλáߺɫ꣨location 2ãȡĬֵ
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StockVertex), (void*)offsetof(StockVertex, Position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StockVertex), (void*)offsetof(StockVertex, Normal));
+            glEnableVertexAttribArray(7);
+            glVertexAttribPointer(7, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(StockVertex), (void*)offsetof(StockVertex, Color));
+            return;
+        }
         // ԿνصԴݣVBOеݽΪԣλáߡ꣩
         // һͶɫlayout (location = x) һһӦ
         // void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer);
@@ -194,8 +528,6 @@ private:
         // vertex color
         glEnableVertexAttribArray(7);
         glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
-        // VAO
-        glBindVertexArray(0);
     }
 };
 #endif
@@ -33,11 +33,19 @@ public:
     bool gammaCorrection;
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false) : gammaCorrection(gamma)
+    // layout ΪԴеĶʽëģͿʹýյ VertexLayout::Stock
+    Model(string const &path, bool gamma = false, VertexLayout layout = VertexLayout::Full)
+        : gammaCorrection(gamma), vertexLayout(layout)
     {
         loadModel(path);
     }
 
+    // Ѿõģͣ Assimp StlLoader ֱӽë
+    Model(vector<Mesh> meshes, VertexLayout layout = VertexLayout::Full)
+        : meshes(std::move(meshes)), gammaCorrection(false), vertexLayout(layout)
+    {
+    }
+
     // 񣬵øԵDraw
     // draws the model, and thus all its meshes
     void Draw(Shader &shader)
@@ -47,6 +55,8 @@ public:
     }
     
 private:
+    VertexLayout vertexLayout;
+
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const &path)
     {
@@ -192,7 +202,7 @@ private:
         }
         
         // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        return Mesh(vertices, indices, textures, vertexLayout);
     }
 
     // ͵λãȡļλã洢Vertex
@@ -237,6 +247,10 @@ inline unsigned int TextureFromFile(const char *path, const string &directory, b
     string filename = string(path);
     filename = directory + '/' + filename;
 
+    // ûOpenGLʱ޴ģʽ
+    if (glGenTextures == nullptr)
+        return 0;
+
     // ID
     unsigned int textureID;
     glGenTextures(1, &textureID);
@@ -5,6 +5,12 @@
 #include <learnopengl/model.h>
 
 #include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
 
 #include "renderer_setup.h"
 #include "model_renderer.h"
@@ -14,11 +20,14 @@
 #include "FPSRecorder.h"
 #include "PathManager.h"
 #include "Method.h"
+#include "frame_profiler.h"
+#include "stl_loader.h"
 
 // Constructor
 Application::Application(const char* title)
     : m_Title(title),
       m_Camera(glm::vec3(0.0f, 0.5f, 2.5f)),
+      m_SimulationClock(1.0f / 60.0f, MAX_SIMULATION_STEPS_PER_FRAME),
       m_MillingManager(0.01f, -0.11f, -0.3f, ToolType::Type) // Same params as main.cpp
 {
 }
@@ -34,6 +43,61 @@ void Application::run()
     mainLoop();
 }
 
+int Application::runHeadless(float timeStep, int maxSteps)
+{
+    initHeadless();
+    // Աȶռʱȱʼë֮ÿλطǰָ߶ȳëʹÿռԱ
+    const bool compareIndexes = m_Config.spatialIndexes.size() > 1 && !ENABLE_HEIGHT_FIELD_STOCK;
+    std::vector<std::vector<Vertex>> initialVertices;
+    const glm::vec3 initialCubePosition = m_CubeWorldPosition;
+    if (compareIndexes)
+    {
+        for (const Mesh& mesh : m_CubeModel->meshes)
+            initialVertices.push_back(mesh.vertices);
+    }
+
+    ReplayResult result = headlessLoop(timeStep, maxSteps);
+    if (compareIndexes)
+        compareSpatialIndexes(timeStep, maxSteps, result, initialVertices, initialCubePosition);
+    if (m_BaselineFile.empty())
+        return 0;
+
+    ReplayResult baseline;
+    if (!m_UpdateBaseline && ReplayBaseline::load(m_BaselineFile, baseline))
+        return ReplayBaseline::compare(baseline, result, m_BaselineTimeTolerance) ? 0 : 1;
+
+    if (!ReplayBaseline::save(m_BaselineFile, result))
+    {
+        std::cerr << "Failed to write replay baseline: " << m_BaselineFile << std::endl;
+        return 1;
+    }
+    std::cout << "Replay baseline saved to " << m_BaselineFile << std::endl;
+    return 0;
+}
+
+void Application::setToolpathFile(const std::string& path, float sceneUnitsPerMm)
+{
+    m_ToolpathFile = path;
+    m_SceneUnitsPerMm = sceneUnitsPerMm;
+}
+
+void Application::setTraceFile(const std::string& path)
+{
+    m_TraceFile = path;
+}
+
+void Application::setReplayBaseline(const std::string& path, bool update, double timeTolerance)
+{
+    m_BaselineFile = path;
+    m_UpdateBaseline = update;
+    m_BaselineTimeTolerance = timeTolerance;
+}
+
+void Application::setConfig(const MillConfig& config)
+{
+    m_Config = config;
+}
+
 void Application::init()
 {
     // Initialize GLFW and create window
@@ -45,7 +109,14 @@ void Application::init()
     // Create managers and handlers
     m_FpsRecorder = new FPSRecorder();
     const float pathMoveSpeed = 0.5f;
+#if ENABLE_SIMULATION_THREAD
+    // ·ڷ߳ƽƶǷ߳Լëλ
+    m_PathManager = new PathManager(m_SimCubeWorldPosition, pathMoveSpeed);
+#else
     m_PathManager = new PathManager(m_CubeWorldPosition, pathMoveSpeed);
+#endif
+    if (!m_ToolpathFile.empty())
+        m_PathManager->LoadToolpath(m_ToolpathFile, m_SceneUnitsPerMm);
     m_InputHandler = new InputHandler(m_Camera, m_CubeWorldPosition, m_ToolBaseWorldPosition, m_EnableMilling, m_MillingKeyPressed, m_DeltaTime, m_FpsRecorder, m_PathManager, SCR_WIDTH, SCR_HEIGHT);
     
     // Set GLFW callbacks
@@ -75,24 +146,171 @@ void Application::init()
     // Create light source
     m_Light = new LightSource(glm::vec3(0.5f, 0.7f, 2.0f));
 
+    loadScene(ENABLE_SIMULATION_THREAD != 0);
+#if ENABLE_PERSISTENT_MAPPED_STREAMING
+    // ëΪ־ӳʽϴ֧ʱ glBufferSubData
+    if (initBufferStorage())
+    {
+        for (Mesh& mesh : m_CubeModel->meshes)
+        {
+            mesh.enableStreaming();
+        }
+    }
+#endif
+    if (m_SimulationModel)
+        startSimulationThread();
+}
+
+void Application::initHeadless()
+{
+    // ʼ GLFW/GLADֻCPUݣϴҲᱻ
+    resetHeadlessPath();
+    loadScene(false);
+}
+
+void Application::resetHeadlessPath()
+{
+    delete m_PathManager;
+    const float pathMoveSpeed = 0.5f;
+    m_PathManager = new PathManager(m_CubeWorldPosition, pathMoveSpeed);
+    if (!m_ToolpathFile.empty())
+        m_PathManager->LoadToolpath(m_ToolpathFile, m_SceneUnitsPerMm);
+}
+
+void Application::loadScene(bool separateSimulationModel)
+{
+    // Initialize milling manager's spatial partition
+    const float surfaceYValue = m_Config.surfaceYValue;
+    const float surfaceYThreshold = m_Config.surfaceYThreshold;
+    const int quadtreeMaxLevels = m_Config.quadtreeMaxLevels;
+    const int quadtreeMaxVertsPerNode = m_Config.quadtreeMaxVertsPerNode;
+#if ENABLE_HEIGHT_FIELD_STOCK
+    const int heightFieldResolution = m_Config.heightFieldResolution;
+#endif
+    if (!m_Config.spatialIndexes.empty())
+        m_MillingManager.setSpatialIndex(m_Config.spatialIndexes[0]); // ģʽֻʹõһ
+    ToolShape toolShape = m_Config.toolShape;
+    if (!m_Config.hasToolType)
+        toolShape.type = m_MillingManager.getToolShape().type;
+    m_MillingManager.setToolShape(toolShape);
+
     // Load models
-    m_CubeModel = new Model(FileSystem::getPath("resources/objects/stl/stl.stl"));
+    const std::string stockPath = FileSystem::getPath("resources/objects/stl/stl.stl");
+#if ENABLE_STOCK_CACHE
+    StockCache::Params cacheParams = { surfaceYValue, surfaceYThreshold, quadtreeMaxLevels, quadtreeMaxVertsPerNode,
+                                       {}, StockCache::currentBuildFlags() };
+    StockCache::setSpatialIndexName(cacheParams, m_MillingManager.getSpatialIndexName());
+    StockCache stockCache;
+    const bool cached = stockCache.open(stockPath, cacheParams);
+    bool writeCache = !cached;
+    m_CubeModel = loadStockModel(stockPath, cached ? &stockCache : nullptr);
+#else
+    m_CubeModel = loadStockModel(stockPath, nullptr);
+#endif
     m_ToolModel = new Model(FileSystem::getPath("resources/objects/obj_tool/tool_obj.obj"));
 
-    // Initialize milling manager's spatial partition
-    float surfaceYValue = 0.0f;
-    float surfaceYThreshold = 0.01f;
-    int quadtreeMaxLevels = 3;
-    int quadtreeMaxVertsPerNode = 20;
-#if ENABLE_QUADTREE_OPTIMIZATION
-    m_MillingManager.initializeSpatialPartition(*m_CubeModel, surfaceYValue, surfaceYThreshold, quadtreeMaxLevels, quadtreeMaxVertsPerNode);
+#if ENABLE_HEIGHT_FIELD_STOCK
+#if ENABLE_STOCK_CACHE
+    // ߶ȳ滻񣬻滻֮ǰд루ռ
+    if (writeCache)
+    {
+        saveStockCache(stockPath, cacheParams, std::vector<char>());
+        writeCache = false;
+    }
+#endif
+    // ߶ȳɵҪOpenGL滻õ񣬷߳ٸ
+    m_MillingManager.initializeHeightField(*m_CubeModel, surfaceYValue, heightFieldResolution, heightFieldResolution);
+#endif
+    if (separateSimulationModel)
+    {
+        // ֻCPUݣеVAO/VBOŲᱻ߳ʹ
+        m_SimulationModel = new Model(*m_CubeModel);
+        m_SimCubeWorldPosition = m_CubeWorldPosition;
+    }
+#if !ENABLE_HEIGHT_FIELD_STOCK
+    // ռǱĶָ
+    if (m_MillingManager.getSpatialIndexName() != "none")
+    {
+        bool restored = false;
+#if ENABLE_STOCK_CACHE
+        // ֻĲд뻺棨ȵĻ治ռݣ
+        if (cached && stockCache.spatialPartitionSize() > 0)
+        {
+            restored = m_MillingManager.restoreSpatialPartition(simulationModel(), stockCache.spatialPartitionData(), stockCache.spatialPartitionSize());
+            writeCache = !restored;
+        }
+#endif
+        if (!restored)
+        {
+            m_MillingManager.initializeSpatialPartition(simulationModel(), surfaceYValue, surfaceYThreshold, quadtreeMaxLevels, quadtreeMaxVertsPerNode);
+        }
+    }
+#endif
+#if ENABLE_STOCK_CACHE
+    if (writeCache)
+    {
+        stockCache.close();
+        std::vector<char> spatialPartition;
+#if !ENABLE_HEIGHT_FIELD_STOCK
+        m_MillingManager.serializeSpatialPartition(simulationModel(), spatialPartition);
+#endif
+        saveStockCache(stockPath, cacheParams, spatialPartition);
+    }
+#endif
+}
+
+void Application::saveStockCache(const std::string& path, const StockCache::Params& params, const std::vector<char>& spatialPartition)
+{
+    if (m_CubeModel->meshes.size() != 1)
+    {
+        return; // ٶȡֻɵAssimp ĶģͲ
+    }
+    if (StockCache::write(path, params, m_CubeModel->meshes[0], spatialPartition))
+        std::cout << "Wrote stock cache " << StockCache::cachePath(path) << std::endl;
+    else
+        std::cout << "Failed to write stock cache " << StockCache::cachePath(path) << std::endl;
+}
+
+Model* Application::loadStockModel(const std::string& path, const StockCache* cache)
+{
+#if ENABLE_COMPACT_STOCK_VERTEX
+    const VertexLayout layout = VertexLayout::Stock;
+#else
+    const VertexLayout layout = VertexLayout::Full;
+#endif
+    auto loadStart = std::chrono::steady_clock::now();
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    if (cache)
+    {
+        cache->readMesh(vertices, indices);
+        std::cout << "Loaded stock from cache " << StockCache::cachePath(path) << ": " << vertices.size() << " vertices in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms" << std::endl;
+        std::vector<Mesh> meshes;
+        meshes.emplace_back(std::move(vertices), std::move(indices), std::vector<Texture>(), layout);
+        return new Model(std::move(meshes), layout);
+    }
+#if ENABLE_FAST_STL_LOADER
+    if (StlLoader::load(path, vertices, indices))
+    {
+        std::cout << "Loaded stock " << path << ": " << indices.size() / 3 << " triangles, " << vertices.size() << " vertices in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms" << std::endl;
+        std::vector<Mesh> meshes;
+        meshes.emplace_back(std::move(vertices), std::move(indices), std::vector<Texture>(), layout);
+        return new Model(std::move(meshes), layout);
+    }
+    std::cout << "Falling back to Assimp for " << path << std::endl;
 #endif
+    return new Model(path, false, layout);
 }
 
 void Application::mainLoop()
 {
+    FrameProfiler::setThreadName("Render");
     while (!glfwWindowShouldClose(m_Window))
     {
+        FrameProfiler::beginFrame();
+
         // Per-frame time logic
         float currentFrame = static_cast<float>(glfwGetTime());
         m_DeltaTime = currentFrame - m_LastFrame;
@@ -102,15 +320,46 @@ void Application::mainLoop()
         m_FpsRecorder->Update(m_DeltaTime);
 
         // Process input
-        m_InputHandler->processInput(m_Window);
+        glm::vec3 cubeBeforeInput = m_CubeWorldPosition;
+        {
+            FrameProfiler::Scope inputScope(FrameProfiler::Input);
+            m_InputHandler->processInput(m_Window);
+        }
 
-        // Update automatic path
-        m_PathManager->Update(m_DeltaTime);
+        if (m_SimulationModel)
+        {
+            // ·ڷ߳нУֻë״̬
+            exchangeSimulationState(m_CubeWorldPosition - cubeBeforeInput);
+        }
+        else
+        {
+#if ENABLE_FIXED_TIMESTEP
+        // ·̶ķ沽ƽһִ֡Ӳ
+        m_SimulationClock.setStepSeconds(simulationStepSeconds());
+        int simulationSteps = m_SimulationClock.advance(m_DeltaTime);
+        for (int step = 0; step < simulationSteps; ++step)
+        {
+            simulationStep(m_SimulationClock.getStepSeconds(), m_ToolBaseWorldPosition, m_EnableMilling);
+        }
+#else
+        simulationStep(m_DeltaTime, m_ToolBaseWorldPosition, m_EnableMilling);
+#endif
+        }
 
-        // Process milling logic
-        m_MillingManager.processMilling(*m_CubeModel, m_CubeWorldPosition, m_ToolBaseWorldPosition, m_EnableMilling);
+        // ÿһη
+        m_SimulationRateWindow += m_DeltaTime;
+        if (m_SimulationRateWindow >= 0.5f)
+        {
+            float distance = traveledDistance() - m_SimulationRateStartDistance;
+            char rateText[64];
+            snprintf(rateText, sizeof(rateText), "Sim: %.1f mm/s", distance / m_SceneUnitsPerMm / m_SimulationRateWindow);
+            m_SimulationRateText = rateText;
+            m_SimulationRateStartDistance = traveledDistance();
+            m_SimulationRateWindow = 0.0f;
+        }
 
         // Render
+        FrameProfiler::Scope drawScope(FrameProfiler::Draw);
         glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -141,23 +390,274 @@ void Application::mainLoop()
         // Render light source cube
         m_LightCubeShader->use();
         m_Light->Draw(*m_LightCubeShader, view, projection);
+        drawScope.stop();
 
         // Render FPS text
+        FrameProfiler::Scope textScope(FrameProfiler::Text);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDisable(GL_DEPTH_TEST);
         m_TextRenderer->RenderText(m_FpsRecorder->GetFPSText(), 10.0f, SCR_HEIGHT - 30.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        m_TextRenderer->RenderText(m_SimulationRateText, 10.0f, SCR_HEIGHT - 60.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
         glEnable(GL_DEPTH_TEST);
         glDisable(GL_BLEND);
+        textScope.stop();
 
         // Swap buffers and poll events
+        FrameProfiler::Scope swapScope(FrameProfiler::Swap);
         glfwSwapBuffers(m_Window);
+        swapScope.stop();
         glfwPollEvents();
+
+        FrameProfiler::endFrame();
+    }
+}
+
+bool Application::simulationStep(float stepSeconds, const glm::vec3& toolBaseWorldPosition, bool enableMilling)
+{
+    {
+        FrameProfiler::Scope pathScope(FrameProfiler::PathUpdate);
+        m_PathManager->Update(stepSeconds);
+    }
+    return m_MillingManager.processMilling(simulationModel(), simulationCubePosition(), toolBaseWorldPosition, enableMilling,
+                                           &m_PathManager->GetPassedWaypoints());
+}
+
+float Application::simulationStepSeconds() const
+{
+    float speed = m_PathManager->GetCurrentSpeed();
+    return speed > 0.0f ? SIMULATION_STEP_MM * m_SceneUnitsPerMm / speed : 1.0f / 60.0f;
+}
+
+float Application::traveledDistance() const
+{
+    return m_SimulationModel ? m_SnapshotTraveledDistance : m_PathManager->GetTraveledDistance();
+}
+
+void Application::startSimulationThread()
+{
+    // ̲߳OpenGLֻҳȾ̴߳ӿȡغϴ
+    m_MillingManager.setDeferredUpload(true);
+    m_StockExchange = std::make_unique<StockSnapshotExchange>(*m_SimulationModel);
+    m_SnapshotCubePosition = m_SimCubeWorldPosition;
+    {
+        std::lock_guard<std::mutex> lock(m_SimulationControlsMutex);
+        m_SimulationControls.toolBaseWorldPosition = m_ToolBaseWorldPosition;
+        m_SimulationControls.enableMilling = m_EnableMilling;
+    }
+    m_SimulationRunning = true;
+    m_SimulationThread = std::thread(&Application::simulationThreadLoop, this);
+}
+
+void Application::stopSimulationThread()
+{
+    m_SimulationRunning = false;
+    if (m_SimulationThread.joinable())
+        m_SimulationThread.join();
+}
+
+void Application::simulationThreadLoop()
+{
+    using Clock = std::chrono::steady_clock;
+
+    FrameProfiler::setThreadName("Simulation");
+    glm::vec3 appliedManualOffset(0.0f);
+    Clock::time_point lastTime = Clock::now();
+    while (m_SimulationRunning.load())
+    {
+        Clock::time_point now = Clock::now();
+        float elapsed = std::chrono::duration<float>(now - lastTime).count();
+        lastTime = now;
+
+        SimulationControls controls;
+        {
+            std::lock_guard<std::mutex> lock(m_SimulationControlsMutex);
+            controls = m_SimulationControls;
+        }
+        // ӦȾֶ߳ƶ
+        glm::vec3 manualStep = controls.manualCubeOffset - appliedManualOffset;
+        appliedManualOffset = controls.manualCubeOffset;
+        m_SimCubeWorldPosition += manualStep;
+
+        // ߳ǰ̶ƽ
+        m_SimulationClock.setStepSeconds(simulationStepSeconds());
+        int steps = m_SimulationClock.advance(elapsed);
+        for (int step = 0; step < steps; ++step)
+        {
+            simulationStep(m_SimulationClock.getStepSeconds(), controls.toolBaseWorldPosition, controls.enableMilling);
+        }
+
+        if (steps == 0 && manualStep == glm::vec3(0.0f))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        StockSnapshot& snapshot = m_StockExchange->writeSnapshot();
+        snapshot.cubeWorldPosition = m_SimCubeWorldPosition;
+        snapshot.appliedManualOffset = appliedManualOffset;
+        snapshot.traveledDistance = m_PathManager->GetTraveledDistance();
+        snapshot.pathActive = m_PathManager->IsPathActive();
+        m_StockExchange->publish(*m_SimulationModel);
+    }
+}
+
+void Application::exchangeSimulationState(const glm::vec3& manualCubeOffset)
+{
+    m_ManualCubeOffsetSent += manualCubeOffset;
+    {
+        std::lock_guard<std::mutex> lock(m_SimulationControlsMutex);
+        m_SimulationControls.toolBaseWorldPosition = m_ToolBaseWorldPosition;
+        m_SimulationControls.manualCubeOffset = m_ManualCubeOffsetSent;
+        m_SimulationControls.enableMilling = m_EnableMilling;
+    }
+
+    if (const StockSnapshot* snapshot = m_StockExchange->acquire())
+    {
+        StockSnapshotExchange::apply(*snapshot, *m_CubeModel);
+        m_SnapshotCubePosition = snapshot->cubeWorldPosition;
+        m_SnapshotManualOffset = snapshot->appliedManualOffset;
+        m_SnapshotTraveledDistance = snapshot->traveledDistance;
+    }
+    // ̻߳ûӦõֶƶȵϣëڻϻ
+    m_CubeWorldPosition = m_SnapshotCubePosition + (m_ManualCubeOffsetSent - m_SnapshotManualOffset);
+
+    FrameProfiler::Scope uploadScope(FrameProfiler::VboUpload);
+    for (Mesh& mesh : m_CubeModel->meshes)
+    {
+#if ENABLE_DIRTY_RANGE_UPLOAD
+        FrameProfiler::Scope meshUploadSpan("Mesh::uploadDirtyVertices");
+        mesh.uploadDirtyVertices();
+#else
+        if (mesh.hasDirtyVertices())
+            mesh.updateVertexBuffer();
+#endif
     }
 }
 
+ReplayResult Application::headlessLoop(float timeStep, int maxSteps)
+{
+    using Clock = std::chrono::steady_clock;
+
+    m_EnableMilling = true;
+    m_PathManager->StartEPath();
+    MillingManager::numVertices = 0;
+    MillingManager::numModifiedVertices = 0;
+
+    if (!m_TraceFile.empty())
+    {
+        FrameProfiler::setThreadName("Headless");
+        FrameProfiler::setTraceCapture(true);
+        FrameProfiler::startRecording();
+    }
+
+    std::vector<double> stepMs; // ÿһ processMilling ĺʱ
+    int modifiedSteps = 0;
+    double simulatedSeconds = 0.0;
+    Clock::time_point runStart = Clock::now();
+    while (m_PathManager->IsPathActive() && (maxSteps <= 0 || static_cast<int>(stepMs.size()) < maxSteps))
+    {
+        float stepSeconds = timeStep > 0.0f ? timeStep : simulationStepSeconds();
+        m_PathManager->Update(stepSeconds);
+        simulatedSeconds += stepSeconds;
+
+        Clock::time_point stepStart = Clock::now();
+        if (m_MillingManager.processMilling(*m_CubeModel, m_CubeWorldPosition, m_ToolBaseWorldPosition, m_EnableMilling,
+                                            &m_PathManager->GetPassedWaypoints()))
+            ++modifiedSteps;
+        stepMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count());
+    }
+    double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+    if (!m_TraceFile.empty())
+    {
+        FrameProfiler::stopRecording();
+        if (FrameProfiler::writeChromeTrace(m_TraceFile))
+            std::cout << "Trace saved to " << m_TraceFile << std::endl;
+        else
+            std::cerr << "Failed to write trace file: " << m_TraceFile << std::endl;
+    }
+    double pathMm = m_PathManager->GetTraveledDistance() / m_SceneUnitsPerMm;
+
+    ReplayResult result;
+    result.toolpath = m_ToolpathFile;
+    result.timeStep = timeStep > 0.0f ? timeStep : 0.0f;
+    result.steps = stepMs.size();
+    result.wallMs = wallMs;
+    result.candidateVertices = MillingManager::numVertices;
+    result.modifiedVertices = MillingManager::numModifiedVertices;
+    result.heightHash = ReplayBaseline::hashVertexHeights(*m_CubeModel);
+
+    std::cout << "======== Headless Milling Report ========" << std::endl;
+    std::cout << "Steps: " << stepMs.size() << " (simulated " << simulatedSeconds
+              << " s), steps with modified vertices: " << modifiedSteps << std::endl;
+    std::cout << "Path length: " << pathMm << " mm" << std::endl;
+    size_t stockVertices = 0;
+    for (const Mesh& mesh : m_CubeModel->meshes)
+        stockVertices += mesh.vertices.size();
+    std::cout << "Stock vertices: " << stockVertices << std::endl;
+    std::cout << "Candidate vertices: " << result.candidateVertices << ", modified vertices: " << result.modifiedVertices
+              << ", height hash: " << std::hex << result.heightHash << std::dec << std::endl;
+    if (stepMs.empty())
+        return result;
+
+    double millingMs = 0.0;
+    for (double ms : stepMs)
+        millingMs += ms;
+    std::sort(stepMs.begin(), stepMs.end());
+    auto percentile = [&](double p) { return stepMs[static_cast<size_t>(p * (stepMs.size() - 1))]; };
+    std::cout << "Wall time: " << wallMs << " ms, milling: " << millingMs << " ms ("
+              << stepMs.size() * 1000.0 / wallMs << " steps/s, " << pathMm * 1000.0 / wallMs << " mm/s)" << std::endl;
+    std::cout << "processMilling per step (ms): avg " << millingMs / stepMs.size()
+              << ", p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+              << ", max " << stepMs.back() << std::endl;
+    return result;
+}
+
+void Application::compareSpatialIndexes(float timeStep, int maxSteps, const ReplayResult& first,
+                                        const std::vector<std::vector<Vertex>>& initialVertices, const glm::vec3& initialCubePosition)
+{
+    const std::vector<std::string>& names = m_Config.spatialIndexes;
+    std::vector<ReplayResult> results(1, first);
+    m_TraceFile.clear(); // trace ֻ¼һռĻط
+    for (size_t i = 1; i < names.size(); ++i)
+    {
+        // ָʼëֻݣĶ鲻·䣬ռеĶָ뱣Ч
+        for (size_t m = 0; m < initialVertices.size(); ++m)
+            std::copy(initialVertices[m].begin(), initialVertices[m].end(), m_CubeModel->meshes[m].vertices.begin());
+        m_CubeWorldPosition = initialCubePosition;
+        resetHeadlessPath();
+        m_MillingManager.resetToolPath();
+
+        std::cout << "======== Spatial index " << names[i] << " ========" << std::endl;
+        m_MillingManager.setSpatialIndex(names[i]);
+        m_MillingManager.initializeSpatialPartition(*m_CubeModel, m_Config.surfaceYValue, m_Config.surfaceYThreshold,
+                                                    m_Config.quadtreeMaxLevels, m_Config.quadtreeMaxVertsPerNode);
+        results.push_back(headlessLoop(timeStep, maxSteps));
+    }
+
+    // Ӧһռȫͬquadtree-z-pruned ʽ֦©㣩
+    std::cout << "======== Spatial Index Comparison ========" << std::endl;
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(20) << "index" << std::right << std::setw(12) << "wall_ms" << std::setw(12) << "steps/s"
+              << std::setw(14) << "candidates" << std::setw(12) << "modified" << std::setw(18) << "height_hash" << "  result" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const ReplayResult& result = results[i];
+        const bool same = result.heightHash == first.heightHash && result.steps == first.steps;
+        std::cout << std::left << std::setw(20) << names[i] << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.wallMs << std::setw(12) << (result.wallMs > 0.0 ? result.steps * 1000.0 / result.wallMs : 0.0)
+                  << std::setw(14) << result.candidateVertices << std::setw(12) << result.modifiedVertices
+                  << std::setw(18) << std::hex << result.heightHash << std::dec
+                  << "  " << (i == 0 ? "reference" : same ? "same" : "DIFFERS") << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(precision);
+}
+
 void Application::cleanup()
 {
+    stopSimulationThread();
+    delete m_SimulationModel;
     delete m_ModelShader;
     delete m_LightCubeShader;
     delete m_CubeModel;
@@ -168,5 +668,6 @@ void Application::cleanup()
     delete m_PathManager;
     delete m_InputHandler;
 
-    glfwTerminate();
+    if (m_Window)
+        glfwTerminate();
 } 
\ No newline at end of file
@@ -4,8 +4,19 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <string>
 #include <learnopengl/camera.h>
 #include "milling_manager.h"
+#include "simulation_clock.h"
+#include "stock_snapshot.h"
+#include "replay_baseline.h"
+#include "stock_cache.h"
+#include "mill_config.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 // Forward declarations
 class Shader;
@@ -28,9 +39,59 @@ public:
 
     void run();
 
+    // ޴ģʽںOpenGLģԹ̶ʱ䲽·
+    // ֱܴͬƣӡʱͳơûʾ/GPUĻϲܡ
+    // timeStep <= 0 ʾʹ봰ģʽͬķ沽 SIMULATION_STEP_MM 㣩
+    // maxSteps Ϊ 0 ʾһֱе·
+    // ˻طŻʱ߱ȽϵĽ0 Ϊһ£򷵻 0
+    // гռʱÿͬĳʼëطͬһ·ӡԱȱ
+    // طŻֻһռĽȽϣ
+    int runHeadless(float timeStep, int maxSteps);
+
+    // ʹGļ· run / runHeadless ֮ǰ
+    void setToolpathFile(const std::string& path, float sceneUnitsPerMm);
+    // ޴ģʽ°еļʱд Chrome trace_event JSON
+    void setTraceFile(const std::string& path);
+    // ޴ģʽļȽͺʱ ReplayBaseline
+    // ļڻ update Ϊ true ʱѱνдΪµĻ
+    void setReplayBaseline(const std::string& path, bool update, double timeTolerance);
+    // ռ涥ʶĲȣ MillConfig run / runHeadless ֮ǰ
+    void setConfig(const MillConfig& config);
+
 private:
     void init();
+    void initHeadless();
+    // ޴ģʽ´··ͷʼ߹ľ
+    void resetHeadlessPath();
+    // ë뵶ģͣʼģʽ޴ģʽã
+    // separateSimulationModel Ϊ true ʱһë߳m_CubeModel ֻڻ
+    void loadScene(bool separateSimulationModel);
+    // ëģͣSTL ʹ StlLoaderʧʱ˵ Assimp
+    // cache Ϊʱֱʹûе
+    Model* loadStockModel(const std::string& path, const StockCache* cache);
+    // ѵǰëֵֻ֧񣩺 spatialPartition д뻺
+    void saveStockCache(const std::string& path, const StockCache::Params& params, const std::vector<char>& spatialPartition);
     void mainLoop();
+    ReplayResult headlessLoop(float timeStep, int maxSteps);
+    //  m_Config еڶ֮Ŀռ»طţÿȻָ initialVertices ëλã
+    // һռĽ first һӡԱȱ
+    void compareSpatialIndexes(float timeStep, int maxSteps, const ReplayResult& first,
+                               const std::vector<std::vector<Vertex>>& initialVertices, const glm::vec3& initialCubePosition);
+    // ִһӲƽ·Ƿж㱻޸
+    bool simulationStep(float stepSeconds, const glm::vec3& toolBaseWorldPosition, bool enableMilling);
+    // ǰٶȰ SIMULATION_STEP_MM Ϊ沽룩
+    float simulationStepSeconds() const;
+
+    // ̣߳·ڶ߳а̶ƽ޸ĹĶ㾭 m_StockExchange Ⱦ߳
+    void startSimulationThread();
+    void stopSimulationThread();
+    void simulationThreadLoop();
+    // Ⱦ̣߳µķ̣߳ȡµë״̬ϴԴ
+    void exchangeSimulationState(const glm::vec3& manualCubeOffset);
+    // ëλã÷߳ʱΪ߳Լĸ
+    Model& simulationModel() { return m_SimulationModel ? *m_SimulationModel : *m_CubeModel; }
+    glm::vec3& simulationCubePosition() { return m_SimulationModel ? m_SimCubeWorldPosition : m_CubeWorldPosition; }
+    float traveledDistance() const;
     void cleanup();
 
 private:
@@ -51,6 +112,42 @@ private:
     bool m_EnableMilling = false;
     bool m_MillingKeyPressed = false;
 
+    // G·ļΪʱʹ PathManager ·
+    std::string m_ToolpathFile;
+    std::string m_TraceFile;
+    std::string m_BaselineFile;
+    bool m_UpdateBaseline = false;
+    double m_BaselineTimeTolerance = 0.1;
+    // 1 ׶ӦĳȣG·沽ͳ
+    float m_SceneUnitsPerMm = 0.01f;
+    MillConfig m_Config;
+
+    // ̶ķʱӣ·ӲƽȾ֡޹
+    SimulationClock m_SimulationClock;
+    // Ļʾķÿʵʱ߹·ȣ
+    std::string m_SimulationRateText = "Sim: 0.0 mm/s";
+    float m_SimulationRateWindow = 0.0f;
+    float m_SimulationRateStartDistance = 0.0f;
+
+    // ߳
+    struct SimulationControls {
+        glm::vec3 toolBaseWorldPosition{ 0.0f };
+        glm::vec3 manualCubeOffset{ 0.0f }; // ֶƶëۼ
+        bool enableMilling = false;
+    };
+    Model* m_SimulationModel = nullptr;       // ߳ë
+    glm::vec3 m_SimCubeWorldPosition{0.0f, 0.0f, 0.0f}; // ߳еëλãPathManager ޸
+    std::unique_ptr<StockSnapshotExchange> m_StockExchange;
+    std::thread m_SimulationThread;
+    std::atomic<bool> m_SimulationRunning{ false };
+    std::mutex m_SimulationControlsMutex;     // ֻ m_SimulationControls Ŀ
+    SimulationControls m_SimulationControls;
+    // Ⱦ߳һ״̬
+    glm::vec3 m_ManualCubeOffsetSent{ 0.0f };
+    glm::vec3 m_SnapshotCubePosition{ 0.0f };
+    glm::vec3 m_SnapshotManualOffset{ 0.0f };
+    float m_SnapshotTraveledDistance = 0.0f;
+
     // Resources (using pointers to manage lifetime)
     Shader* m_ModelShader = nullptr;
     Shader* m_LightCubeShader = nullptr;
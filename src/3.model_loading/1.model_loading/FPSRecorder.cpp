@@ -6,8 +6,10 @@
 #include <fstream>
 #include <chrono>
 #include <ctime>
-#include <direct.h>  // For _mkdir
+#include <filesystem> // For create_directories
 #include "milling_manager.h"
+#include "frame_profiler.h"
+#include "Method.h"
 FPSRecorder::FPSRecorder()
     : m_isRecording(false),
       m_fpsText("FPS: 0.0"),
@@ -67,15 +69,21 @@ void FPSRecorder::StartRecording()
     m_recordedFPS.clear();
     MillingManager::numVertices = 0;
     MillingManager::numModifiedVertices = 0;
+    FrameProfiler::setTraceCapture(ENABLE_CHROME_TRACE_EXPORT != 0);
+    FrameProfiler::startRecording();
     std::cout << "======== FPS Recording Started ========" << std::endl;
 }
 
 void FPSRecorder::StopRecordingAndReport()
 {
+    FrameProfiler::stopRecording();
     std::cout << "======== FPS Recording Stopped ========" << std::endl;
     if (m_recordedFPS.empty())
     {
+        // ¼ʱ䲻һFPSͳʱûFPS׶εĺʱȻЧճ
         std::cout << "No FPS data was recorded." << std::endl;
+        std::cout << FrameProfiler::report();
+        std::cout << "=====================================" << std::endl;
         return;
     }
 
@@ -83,7 +91,8 @@ void FPSRecorder::StopRecordingAndReport()
     // Create a directory for logs if it doesn't exist
     // The executable is typically in a subdirectory like 'build/bin/Debug', 
     // so we go up three levels to the project root.
-    _mkdir("../../../logs");
+    std::error_code mkdirError;
+    std::filesystem::create_directories("../../../logs", mkdirError);
 
     // Generate a timestamp for the filename
     auto now = std::chrono::system_clock::now();
@@ -114,7 +123,9 @@ void FPSRecorder::StopRecordingAndReport()
     {
         report << m_recordedFPS[i] << ( (i % 10 == 9) ? "\n" : "\t" );
     }
-    report << std::endl << "=====================================" << std::endl;
+    report << std::endl;
+    report << FrameProfiler::report();
+    report << "=====================================" << std::endl;
 
     // Print to console
     std::cout << report.str();
@@ -125,5 +136,13 @@ void FPSRecorder::StopRecordingAndReport()
 
     std::cout << "FPS data saved to " << filename << std::endl;
 
+#if ENABLE_CHROME_TRACE_EXPORT
+    std::string traceFilename = "../../../logs/trace_" + ss_time.str() + ".json";
+    if (FrameProfiler::writeChromeTrace(traceFilename))
+        std::cout << "Trace saved to " << traceFilename << std::endl;
+    else
+        std::cerr << "Failed to write trace file: " << traceFilename << std::endl;
+#endif
+
     m_recordedFPS.clear();
 } 
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 // ---  ---
-// Ϊ 1 ͷ Ϊ 0 ʹƽ׵
+// Ϊ 1 ͷ Ϊ 0 ʹƽ׵ţǵ׶ȵǵͷͨļ tool ѡ񣬼 MillConfig
 #if 1
 #define Type ball
 #elif
@@ -12,16 +12,86 @@
 // Ϊ 1 ʹ·, Ϊ 0 ʹZ·
 #define USE_SPIRAL_PATH 0
 
+// --- ëʾ ---
+// Ϊ 1 ʹø߶ȳZ-mapʾëϽкɻõ
+// Ϊ 0 ֱ޸STLģ͵ Mesh 
+#define ENABLE_HEIGHT_FIELD_STOCK 0
+
 // --- Ż ---
 // Ϊ 1 Ĳռ, Ϊ 0 ʹñ
+// ĲZ߿ֻĬϵĿռʱ --spatial-index 
+//  ļ spatial_index ѡ spatial_index.h еһʵ֣ main.cpp
 #define ENABLE_QUADTREE_OPTIMIZATION 0
 
+// Ϊ 1 ʹԣʽĲڵ㰴Mortonǰ׺УҶӶͬһ
+// Ϊ 0 ʹڵ new ָĲ
+#define ENABLE_LINEAR_QUADTREE 0
+
 // Ϊ 1 ڹĲZŻ
 #define ENABLE_Z_ORDER_OPTIMIZATION 0
 
 // Ϊ 1 ZŻĲѯʽ֦
 #define ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING 0
 
+// Ϊ 1 ZҶаѲѯԲİΧвΪMorton䣬ֲҺȷж
+// Ϊ 0 ʹôĵɢʽ֦
+// ֻ Quadtree::zOrderQueryMode Ĭֵռ quadtree-z / quadtree-z-scan /
+//  quadtree-z-pruned ʱֱѡַʽ spatial_index.h
+#define ENABLE_Z_ORDER_RANGE_QUERY 1
+
+// Ϊ 1 ĲҶжⱣSoAXZ붥ţ飬ѯʱAVX2/AVX-512жϣ
+// ڵĶ±귵ءSoA optimize() й˿ִܻZŻ
+// Ϊ 0 ѯʱ Vertex* ж
+#define ENABLE_SOA_LEAF_QUERY 0
+
+// Ϊ 1 ɨĺѡֿ齻̳߳زд봮ȫһ
+#define ENABLE_PARALLEL_MILLING 1
+// ʹõ߳Ⱦ̣߳0 ʾʹӲ߳
+#define PARALLEL_MILLING_THREADS 0
+
+// Ϊ 1 ʱҳλͼб޸ĹĶ㣬ֻϴЩҳϲڵҳ
+// Ϊ 0 ж㱻޸ʱϴĶ㻺
+#define ENABLE_DIRTY_RANGE_UPLOAD 1
+
+// Ϊ 1 ëʹ glBufferStorage ־ӳ嶥ֱдӳڴ
+// Ҫ OpenGL 4.4  GL_ARB_buffer_storage֧ʱԶʹ glBufferSubData
+#define ENABLE_PERSISTENT_MAPPED_STREAMING 0
+
+// Ϊ 1 ëԴʹ20ֽڵĽն㣨λ float3 10:10:10:2ɫ RGBA8
+// ϴԼΪ Vertex100ֽڣ֮һȻ޸ Vertexϴʱٴ
+#define ENABLE_COMPACT_STOCK_VERTEX 1
+
+// Ϊ 1 ʱë STL  StlLoader ֱӽڴӳ䡢нظ㣩
+//  AssimpʧʱԻ˵ Assimp
+#define ENABLE_FAST_STL_LOADER 1
+
+// Ϊ 1 ʱһѺӺëͽõĲд <ëļ>.millcache
+// ֮ʱֱӴӻȡļĿر仯Զɣ
+#define ENABLE_STOCK_CACHE 1
+
+// --- ʱ ---
+// Ϊ 1 ·̶ķ沽ƽÿִ֡Ӳ֡޹
+// Ϊ 0 ÿȾһ֡ƽһΣΪ֡
+#define ENABLE_FIXED_TIMESTEP 1
+// ÿӲ·ƶľ루ף浱ǰٶȻΪʱ
+#define SIMULATION_STEP_MM 0.5f
+// ÿִ֡еķӲȾʱʱ䣬Խ׷Խ
+#define MAX_SIMULATION_STEPS_PER_FRAME 8
+
+// Ϊ 1 ·ڶķ߳а̶У޸ĹĶ㾭彻Ⱦ߳ϴ
+// Ⱦȴ߳һëڴռһݶݣ
+// Ϊ 0 Ⱦִ߳֡У޴ģʽǵ̣߳
+#define ENABLE_SIMULATION_THREAD 1
+
+// --- ģʽ ---
+// Ϊ 1 һ֡ǰ֡ɨͷΪ壬ƽ׵Ϊܵ壩
+// Ϊ 0 ֻڵǰ֡λô
+#define ENABLE_SWEPT_MILLING 1
+
 // ---  ---
+// Ϊ 1 ʱ R ¼ڼͬʱɼ̵߳ļʱ䣬ֹͣ¼ʱ logs Ŀ¼¶д
+// Chrome trace_event ʽ trace_<ʱ>.json chrome://tracing  ui.perfetto.dev 򿪣
+#define ENABLE_CHROME_TRACE_EXPORT 1
+
 // Ϊ 1 ڹĲӡԹ
 #define ENABLE_QUADTREE_DEBUG_PRINT 1 
\ No newline at end of file
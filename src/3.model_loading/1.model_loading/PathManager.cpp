@@ -11,7 +11,8 @@ PathManager::PathManager(glm::vec3& workpiecePosition, float movementSpeed)
     : workpiecePosition_(workpiecePosition),
       movementSpeed_(movementSpeed),
       currentWaypointIndex_(0),
-      isPathActive_(false) 
+      isPathActive_(false),
+      currentSpeed_(movementSpeed)
 {
     InitializeEPath();
 }
@@ -86,12 +87,35 @@ void PathManager::InitializeEPath()
 #endif
 }
 
+void PathManager::LoadToolpath(const std::string& path, float sceneUnitsPerMm)
+{
+    toolpathFile_ = path;
+    sceneUnitsPerMm_ = sceneUnitsPerMm;
+    std::cout << "Toolpath file: " << path << std::endl;
+}
+
 void PathManager::StartEPath() 
 {
-    if (!isPathActive_) {
-        isPathActive_ = true;
-        currentWaypointIndex_ = 0;
-        std::cout << "Starting 'e' path machining..." << std::endl;
+    if (!isPathActive_.exchange(true)) {
+        startRequested_ = true;
+        if (toolpathFile_.empty()) {
+            std::cout << "Starting 'e' path machining..." << std::endl;
+        } else {
+            std::cout << "Starting toolpath " << toolpathFile_ << "..." << std::endl;
+        }
+    }
+}
+
+void PathManager::BeginPath()
+{
+    currentWaypointIndex_ = 0;
+    toolpathReader_.reset();
+    if (!toolpathFile_.empty()) {
+        // ÿļͷ½
+        toolpathReader_ = std::make_unique<GCodeToolpathReader>(toolpathFile_, sceneUnitsPerMm_);
+        toolpathBatch_.clear();
+        toolpathBatchIndex_ = 0;
+        pathOriginY_ = workpiecePosition_.y;
     }
 }
 
@@ -100,41 +124,92 @@ bool PathManager::IsPathActive() const
     return isPathActive_;
 }
 
-void PathManager::Update(float deltaTime) 
+bool PathManager::CurrentTarget(glm::vec3& target, float& speed, bool& waiting)
 {
-    if (!isPathActive_) {
-        return;
+    waiting = false;
+    if (!toolpathReader_) {
+        if (currentWaypointIndex_ >= static_cast<int>(pathWaypoints_.size())) {
+            return false;
+        }
+        target = pathWaypoints_[currentWaypointIndex_];
+        // ·滮ֻXZƽϽ
+        target.y = workpiecePosition_.y;
+        speed = movementSpeed_;
+        return true;
     }
 
-    if (currentWaypointIndex_ >= pathWaypoints_.size()) {
-        if (isPathActive_) {
-            isPathActive_ = false;
-            std::cout << "Path finished." << std::endl;
+    if (toolpathBatchIndex_ >= toolpathBatch_.size()) {
+        if (!toolpathReader_->tryPopBatch(toolpathBatch_)) {
+            waiting = !toolpathReader_->isFinished(); // ̻߳ûʱ֡ͣԭ
+            return false;
         }
-        return;
+        toolpathBatchIndex_ = 0;
     }
+    const ToolpathWaypoint& waypoint = toolpathBatch_[toolpathBatchIndex_];
+    // ߹̶ëƶ̧൱ë½
+    target = glm::vec3(-waypoint.position.x, pathOriginY_ - waypoint.position.y, -waypoint.position.z);
+    speed = waypoint.speed > 0.0f ? waypoint.speed : movementSpeed_;
+    return true;
+}
 
-    glm::vec3 targetPosition = pathWaypoints_[currentWaypointIndex_];
-    glm::vec3 currentPosition = workpiecePosition_;
-    
-    // ·滮ֻXZƽϽ
-    targetPosition.y = currentPosition.y;
+void PathManager::AdvanceWaypoint()
+{
+    if (toolpathReader_) {
+        ++toolpathBatchIndex_;
+    } else {
+        ++currentWaypointIndex_;
+    }
+}
 
-    glm::vec3 direction = targetPosition - currentPosition;
-    
-    float distance = glm::length(direction);
-    const float waypointThreshold = 0.01f;
+void PathManager::Update(float deltaTime) 
+{
+    passedWaypoints_.clear();
+    if (!isPathActive_) {
+        return;
+    }
+    if (startRequested_.exchange(false)) {
+        BeginPath();
+    }
 
-    if (distance < waypointThreshold) {
-        currentWaypointIndex_++;
-    } else {
-        glm::vec3 moveVector = glm::normalize(direction) * movementSpeed_ * deltaTime;
-        // ֹƶͷ
-        if (glm::length(moveVector) > distance) {
+    // ֡ƶʱԿԽ㣬ܼĶ߶ΣϸֺԲᱻ֡ٶ
+    float remainingTime = deltaTime;
+    while (remainingTime > 0.0f) {
+        glm::vec3 targetPosition;
+        float speed;
+        bool waiting;
+        if (!CurrentTarget(targetPosition, speed, waiting)) {
+            if (!waiting) {
+                isPathActive_ = false;
+                if (toolpathReader_) {
+                    std::cout << "Toolpath finished (" << toolpathReader_->getLinesParsed() << " lines)." << std::endl;
+                    toolpathReader_.reset();
+                }
+                currentSpeed_ = movementSpeed_;
+                std::cout << "Path finished." << std::endl;
+            }
+            return;
+        }
+        if (speed <= 0.0f) {
+            return;
+        }
+        currentSpeed_ = speed;
+
+        glm::vec3 direction = targetPosition - workpiecePosition_;
+        float distance = glm::length(direction);
+        float step = speed * remainingTime;
+        if (distance <= step) {
+            // ﺽ㣬ʣʱһ
             workpiecePosition_ = targetPosition;
-            currentWaypointIndex_++;
+            traveledDistance_ += distance;
+            remainingTime -= distance / speed;
+            AdvanceWaypoint();
+            if (remainingTime > 0.0f) {
+                passedWaypoints_.push_back(workpiecePosition_);
+            }
         } else {
-            workpiecePosition_ += moveVector;
+            workpiecePosition_ += direction * (step / distance);
+            traveledDistance_ += step;
+            remainingTime = 0.0f;
         }
     }
-} 
\ No newline at end of file
+}
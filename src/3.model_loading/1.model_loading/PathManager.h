@@ -2,8 +2,12 @@
 #define PATH_MANAGER_H
 
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <glm/glm.hpp>
 #include <iostream>
+#include "gcode_reader.h"
 
 class PathManager {
 public:
@@ -12,21 +16,53 @@ public:
     // ÿ֡Ըëλ
     void Update(float deltaTime);
 
-    // Ԥ 'e' ·
+    // Ԥ 'e' ·̵߳ãֻǼһ Update ʼִ
     void StartEPath();
 
-    // ·ǰǷִ
+    // ·ǰǷִУ̵߳ã
     bool IsPathActive() const;
 
+    // GļΪ·StartEPath ʱں̨ʼʽUpdate ִ߽С
+    // sceneUnitsPerMm Ϊ 1 ׶Ӧĳȡ·ͬʱë߶ȣG Z
+    void LoadToolpath(const std::string& path, float sceneUnitsPerMm);
+
+    // ǰεĽٶȣλ/룩·δִʱΪĬٶ
+    float GetCurrentSpeed() const { return currentSpeed_; }
+    // ·ִëۼƶľ루λ
+    float GetTraveledDistance() const { return traveledDistance_; }
+    // һ Update ;еĺ㴦ëλã˳򣬲֡λã
+    // ʱҪɨӣսǻᱻسҡµƽƻб
+    const std::vector<glm::vec3>& GetPassedWaypoints() const { return passedWaypoints_; }
+
 private:
     // ʼ 'e' ·ĺ
     void InitializeEPath();
 
+    // ȡǰĿ꺽㣻ʽ·ĵǰʱӶȡȡһ
+    // ·ѽ false̻߳ûºʱ waiting Ϊ true
+    bool CurrentTarget(glm::vec3& target, float& speed, bool& waiting);
+    void AdvanceWaypoint();
+    //  Update ڵ߳дú´Gļ
+    void BeginPath();
+
     glm::vec3& workpiecePosition_;          // ë
     std::vector<glm::vec3> pathWaypoints_;  // 洢·
     int currentWaypointIndex_;              // ǰĿ꺽
     float movementSpeed_;                   // ë·ƶٶ
-    bool isPathActive_;                     // ·Ƿִеı־
+    std::atomic<bool> isPathActive_;        // ·Ƿִеı־
+    std::atomic<bool> startRequested_{ false };
+
+    // G·
+    std::string toolpathFile_;                          // Ϊʱʹ InitializeEPath ɵ·
+    float sceneUnitsPerMm_ = 0.01f;
+    std::unique_ptr<GCodeToolpathReader> toolpathReader_;
+    std::vector<ToolpathWaypoint> toolpathBatch_;       // ǰִеһ
+    size_t toolpathBatchIndex_ = 0;
+    float pathOriginY_ = 0.0f;                          // ʼִʱëĸ߶ȣӦG Z = 0
+
+    float currentSpeed_;
+    float traveledDistance_ = 0.0f;
+    std::vector<glm::vec3> passedWaypoints_;
 };
 
 #endif // PATH_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,266 @@
+// Ĳ / 񹹽뷶Χѯ΢׼ԣmill_bench Ŀ꣬ҪںOpenGLģ
+//
+//  10^4 ~ 10^7 λ y = 0 ƽϵĺϳɶ㣨ȷֲɴطֲ֣ÿ
+// maxLevels / maxVerticesPerNode ò
+//   -  Quadtree::insert Ľʱ䣬Լ Quadtree::bulkLoadб + 򣩵Ľʱ
+//   - optimize()ҶZ򣩵ʱ
+//   - ͬѯ뾶 queryRange  ns/query  candidates/queryֱ optimize() ֮ǰ
+//     Ҷδɨ裩֮ZҶӣҶβ
+//     Quadtree::ZOrderQueryMode ֲѯʽMorton / ɨ / ֦ɨ裩
+//   - ѯʹ׷ʽ queryRangeڲѯ֮ոãʱвڴ
+//   - Աõ UniformGridIndexԪ߳ȡѯ뾶 MillingManager ȡ߰뾶һ£
+//     ʱ ns/queryÿĲ֮ "grid" 
+//   -  "default" егӦĬãȷֲ 10^4 㡢3 / 20뾶 0.01Ľ
+//     zrange_gain ΪδMortonѯ ns/query ֮ȣ 1 ʾZ죩
+//
+// ÷mill_bench [--max-points N] [--min-points N] [--budget ] [--seed S]
+//   --max-points / --min-points  Χ10Ĭ 10000 ~ 10000000
+//   --budget                     ÿ뾶ĲѯʱԤ㣨Ĭ 0.2 룩
+#include "../quadtree.h"
+#include "../thread_pool.h"
+#include "../uniform_grid_index.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const glm::vec2 BOUNDS_MIN(-1.0f, -1.0f);
+    const glm::vec2 BOUNDS_MAX(1.0f, 1.0f);
+
+    struct TreeSettings {
+        int maxLevels;
+        int maxVerticesPerNode;
+    };
+
+    // ӦĬã3 / 20Լ
+    const TreeSettings TREE_SETTINGS[] = {
+        { 3, 20 }, { 6, 20 }, { 6, 128 }, { 9, 20 }, { 9, 128 }
+    };
+
+    const float QUERY_RADII[] = { 0.01f, 0.03f, 0.1f };
+
+    // "default" жӦãTREE_SETTINGS[0]QUERY_RADII[0]
+    const size_t DEFAULT_POINT_COUNT = 10000;
+
+    enum class Distribution { Uniform, Clustered };
+
+    const char* distributionName(Distribution distribution) {
+        return distribution == Distribution::Uniform ? "uniform" : "clustered";
+    }
+
+    //  y = 0 ƽɶ㡣ɴطֲģֲܵ32 ˹أڱ߽ĵ²
+    std::vector<Vertex> generatePoints(Distribution distribution, size_t count, std::mt19937& rng) {
+        std::vector<Vertex> points(count);
+        std::uniform_real_distribution<float> uniform(BOUNDS_MIN.x, BOUNDS_MAX.x);
+        if (distribution == Distribution::Uniform) {
+            for (Vertex& vertex : points) {
+                vertex.Position = glm::vec3(uniform(rng), 0.0f, uniform(rng));
+            }
+            return points;
+        }
+
+        const int CLUSTER_COUNT = 32;
+        const float CLUSTER_SIGMA = 0.03f;
+        std::vector<glm::vec2> centers(CLUSTER_COUNT);
+        for (glm::vec2& center : centers) {
+            center = glm::vec2(uniform(rng), uniform(rng));
+        }
+        std::uniform_int_distribution<int> pickCluster(0, CLUSTER_COUNT - 1);
+        std::normal_distribution<float> offset(0.0f, CLUSTER_SIGMA);
+        for (Vertex& vertex : points) {
+            glm::vec2 p;
+            do {
+                p = centers[pickCluster(rng)] + glm::vec2(offset(rng), offset(rng));
+            } while (p.x < BOUNDS_MIN.x || p.x > BOUNDS_MAX.x || p.y < BOUNDS_MIN.y || p.y > BOUNDS_MAX.y);
+            vertex.Position = glm::vec3(p.x, 0.0f, p.y);
+        }
+        return points;
+    }
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct QueryResult {
+        double nsPerQuery;
+        double candidatesPerQuery;
+    };
+
+    const Quadtree::ZOrderQueryMode Z_ORDER_QUERY_MODES[] = {
+        Quadtree::ZOrderQueryMode::RangeQuery,
+        Quadtree::ZOrderQueryMode::CenterScan,
+        Quadtree::ZOrderQueryMode::CenterScanPruned,
+    };
+    const size_t Z_ORDER_QUERY_MODE_COUNT = sizeof(Z_ORDER_QUERY_MODES) / sizeof(Z_ORDER_QUERY_MODES[0]);
+
+    // ʹ centers еĲѯģֱʱԤ㣨ٲѯ 32 Σ
+    // ׷ӵͬһ飬ÿβѯǰգúٷڴ
+    template <typename Index>
+    QueryResult measureQueries(const Index& index, const std::vector<glm::vec2>& centers, float radius, double budgetSeconds) {
+        const size_t MIN_QUERIES = 32;
+        size_t queries = 0;
+        size_t candidates = 0;
+        std::vector<Vertex*> result;
+        Clock::time_point start = Clock::now();
+        while (queries < centers.size()) {
+            result.clear();
+            index.queryRange(centers[queries], radius, result);
+            candidates += result.size();
+            ++queries;
+            // ÿ 16 βѯһʱӣʱӰС뾶Ľ
+            if ((queries & 15) == 0 && queries >= MIN_QUERIES &&
+                std::chrono::duration<double>(Clock::now() - start).count() >= budgetSeconds) {
+                break;
+            }
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        return { elapsed * 1e9 / queries, static_cast<double>(candidates) / queries };
+    }
+
+    struct DefaultRow {
+        bool measured;
+        QueryResult unsorted;
+        QueryResult zRange;
+    };
+
+    void printHeader() {
+        std::cout << std::left << std::setw(16) << "dist" << std::right
+                  << std::setw(10) << "points" << std::setw(7) << "levels" << std::setw(7) << "cap"
+                  << std::setw(11) << "build_ms" << std::setw(11) << "bulk_ms" << std::setw(11) << "optim_ms" << std::setw(8) << "radius"
+                  << std::setw(12) << "cand/query" << std::setw(14) << "ns/q_unsort" << std::setw(14) << "ns/q_zrange"
+                  << std::setw(14) << "ns/q_zscan" << std::setw(14) << "ns/q_zpruned"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t minPoints = 10000;
+    size_t maxPoints = 10000000;
+    double budgetSeconds = 0.2;
+    unsigned seed = 12345;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-points") == 0 && i + 1 < argc)
+            maxPoints = static_cast<size_t>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--min-points") == 0 && i + 1 < argc)
+            minPoints = static_cast<size_t>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budgetSeconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    }
+
+    const size_t QUERY_CENTER_COUNT = 1 << 16;
+    ThreadPool pool; // ʹȫӲ߳
+    std::cout << std::fixed << std::setprecision(2);
+    printHeader();
+    DefaultRow defaultRow = { false, { 0.0, 0.0 }, { 0.0, 0.0 } };
+
+    for (Distribution distribution : { Distribution::Uniform, Distribution::Clustered }) {
+        for (size_t count = minPoints; count <= maxPoints; count *= 10) {
+            std::mt19937 rng(seed);
+            std::vector<Vertex> points = generatePoints(distribution, count, rng);
+
+            // ѯȡԵƱɴطֲʱѯͬڼ뵶ƶһ£
+            std::vector<glm::vec2> centers(QUERY_CENTER_COUNT);
+            std::uniform_int_distribution<size_t> pickPoint(0, count - 1);
+            for (glm::vec2& center : centers) {
+                const glm::vec3& position = points[pickPoint(rng)].Position;
+                center = glm::vec2(position.x, position.z);
+            }
+
+            for (const TreeSettings& settings : TREE_SETTINGS) {
+                Quadtree tree(BOUNDS_MIN, BOUNDS_MAX, settings.maxLevels, settings.maxVerticesPerNode);
+                Clock::time_point buildStart = Clock::now();
+                for (Vertex& vertex : points) {
+                    tree.insert(&vertex);
+                }
+                double buildMs = elapsedMs(buildStart);
+
+                std::vector<Vertex*> pointers(points.size());
+                for (size_t i = 0; i < points.size(); ++i) {
+                    pointers[i] = &points[i];
+                }
+                Quadtree bulkTree(BOUNDS_MIN, BOUNDS_MAX, settings.maxLevels, settings.maxVerticesPerNode);
+                Clock::time_point bulkStart = Clock::now();
+                bulkTree.bulkLoad(pointers, &pool);
+                double bulkMs = elapsedMs(bulkStart);
+
+                QueryResult unsorted[sizeof(QUERY_RADII) / sizeof(QUERY_RADII[0])];
+                for (size_t r = 0; r < sizeof(QUERY_RADII) / sizeof(QUERY_RADII[0]); ++r) {
+                    unsorted[r] = measureQueries(tree, centers, QUERY_RADII[r], budgetSeconds);
+                }
+
+                Clock::time_point optimizeStart = Clock::now();
+                tree.optimize();
+                double optimizeMs = elapsedMs(optimizeStart);
+
+                for (size_t r = 0; r < sizeof(QUERY_RADII) / sizeof(QUERY_RADII[0]); ++r) {
+                    // cand/query ȡMortonѯδʱ֦ͬɨһЩ
+                    QueryResult sorted[Z_ORDER_QUERY_MODE_COUNT];
+                    for (size_t m = 0; m < Z_ORDER_QUERY_MODE_COUNT; ++m) {
+                        tree.zOrderQueryMode = Z_ORDER_QUERY_MODES[m];
+                        sorted[m] = measureQueries(tree, centers, QUERY_RADII[r], budgetSeconds);
+                    }
+                    std::cout << std::left << std::setw(16) << distributionName(distribution) << std::right
+                              << std::setw(10) << count << std::setw(7) << settings.maxLevels
+                              << std::setw(7) << settings.maxVerticesPerNode
+                              << std::setw(11) << buildMs << std::setw(11) << bulkMs << std::setw(11) << optimizeMs
+                              << std::setw(8) << std::setprecision(3) << QUERY_RADII[r] << std::setprecision(2)
+                              << std::setw(12) << sorted[0].candidatesPerQuery
+                              << std::setw(14) << unsorted[r].nsPerQuery;
+                    for (const QueryResult& result : sorted) {
+                        std::cout << std::setw(14) << result.nsPerQuery;
+                    }
+                    std::cout << std::endl;
+
+                    if (distribution == Distribution::Uniform && count == DEFAULT_POINT_COUNT && &settings == &TREE_SETTINGS[0] && r == 0) {
+                        defaultRow = { true, unsorted[r], sorted[0] };
+                    }
+                }
+            }
+
+            // levels / cap XZĵԪֻһַʽbuild_ms  bulk_ms ͬ
+            // û optimize 裬 ns/query ͬ
+            for (float radius : QUERY_RADII) {
+                std::vector<Vertex*> pointers(points.size());
+                for (size_t i = 0; i < points.size(); ++i) {
+                    pointers[i] = &points[i];
+                }
+                UniformGridIndex grid(BOUNDS_MIN, BOUNDS_MAX, radius);
+                Clock::time_point gridStart = Clock::now();
+                grid.build(pointers, &pool);
+                double gridMs = elapsedMs(gridStart);
+                QueryResult result = measureQueries(grid, centers, radius, budgetSeconds);
+                std::cout << std::left << std::setw(16) << (std::string(distributionName(distribution)) + "/grid") << std::right
+                          << std::setw(10) << count << std::setw(7) << grid.getCellsX() << std::setw(7) << grid.getCellsZ()
+                          << std::setw(11) << gridMs << std::setw(11) << gridMs << std::setw(11) << 0.0
+                          << std::setw(8) << std::setprecision(3) << radius << std::setprecision(2)
+                          << std::setw(12) << result.candidatesPerQuery
+                          << std::setw(14) << result.nsPerQuery;
+                for (size_t m = 0; m < Z_ORDER_QUERY_MODE_COUNT; ++m) {
+                    std::cout << std::setw(14) << result.nsPerQuery;
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    if (defaultRow.measured) {
+        std::cout << std::endl << std::left << std::setw(16) << "default" << std::right
+                  << std::setw(10) << DEFAULT_POINT_COUNT << std::setw(7) << TREE_SETTINGS[0].maxLevels
+                  << std::setw(7) << TREE_SETTINGS[0].maxVerticesPerNode
+                  << std::setw(8) << std::setprecision(3) << QUERY_RADII[0] << std::setprecision(2)
+                  << "  ns/q_unsort " << defaultRow.unsorted.nsPerQuery
+                  << "  ns/q_zrange " << defaultRow.zRange.nsPerQuery
+                  << "  zrange_gain " << defaultRow.unsorted.nsPerQuery / defaultRow.zRange.nsPerQuery << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef BINARY_BLOB_H
+#define BINARY_BLOB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// ļȶݵ˳д/ȡֻֿ֧ƽƵֽͣ򱣴档
+class BlobWriter {
+public:
+    explicit BlobWriter(std::vector<char>& out) : out_(out) {}
+
+    template <typename T>
+    void write(const T& value) {
+        writeArray(&value, 1);
+    }
+
+    template <typename T>
+    void writeArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "BlobWriter only writes trivially copyable types");
+        const char* bytes = reinterpret_cast<const char*>(values);
+        out_.insert(out_.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    // д볤ǰ׺飬 BlobReader::readVector Ӧ
+    template <typename T, typename Alloc>
+    void writeVector(const std::vector<T, Alloc>& values) {
+        write(static_cast<uint64_t>(values.size()));
+        writeArray(values.data(), values.size());
+    }
+
+private:
+    std::vector<char>& out_;
+};
+
+// ȡԽ ok() Ϊ false֮Ķȡʧܣֻһ
+class BlobReader {
+public:
+    BlobReader(const char* data, size_t size) : p_(data), end_(data + size), ok_(true) {}
+
+    template <typename T>
+    bool read(T& value) {
+        return readArray(&value, 1);
+    }
+
+    template <typename T>
+    bool readArray(T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "BlobReader only reads trivially copyable types");
+        if (!ok_ || count > static_cast<size_t>(end_ - p_) / sizeof(T)) {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(values, p_, count * sizeof(T));
+        p_ += count * sizeof(T);
+        return true;
+    }
+
+    // ȡǰ׺
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+        uint64_t count = 0;
+        if (!read(count) || count > static_cast<size_t>(end_ - p_) / sizeof(T)) {
+            ok_ = false;
+            return false;
+        }
+        values.resize(static_cast<size_t>(count));
+        return readArray(values.data(), values.size());
+    }
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return p_ == end_; }
+
+private:
+    const char* p_;
+    const char* end_;
+    bool ok_;
+};
+
+#endif // BINARY_BLOB_H
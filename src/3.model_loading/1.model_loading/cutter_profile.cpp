@@ -0,0 +1,109 @@
+#include "cutter_profile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // бʵޣԲԵбΪ󣬷ֻҪ򣬽ضϲӰ
+    const float MAX_SLOPE = 1e3f;
+    // ׶ȵǵ뵶СнǡнΪ0ʱǰ뾶Сڵ߰뾶Բ棬
+    // Բⲻڵߣ޷ð뾶-߶߱ʾ1ȴʱ涸е
+    const float MIN_TAPER_ANGLE_DEGREES = 1.0f;
+}
+
+AptCutterParameters CutterProfile::aptParameters(const ToolShape& shape, float radius) {
+    AptCutterParameters apt;
+    apt.diameter = 2.0f * radius;
+    switch (shape.type) {
+        case ToolType::ball:
+            apt.cornerRadius = radius;
+            apt.cornerCenterAxial = radius;
+            break;
+        case ToolType::bullNose: {
+            float corner = glm::clamp(shape.cornerRadius, 0.0f, radius);
+            apt.cornerRadius = corner;
+            apt.cornerCenterRadial = radius - corner;
+            apt.cornerCenterAxial = corner;
+            break;
+        }
+        case ToolType::tapered: {
+            // ͷУͷ뾶Ϊ0ʱ˻ΪͷԲ׶
+            float tip = glm::clamp(shape.tipRadius, 0.0f, radius);
+            apt.cornerRadius = tip;
+            apt.cornerCenterAxial = tip;
+            apt.sideAngleDegrees = glm::clamp(shape.taperAngleDegrees, MIN_TAPER_ANGLE_DEGREES, 90.0f);
+            break;
+        }
+        case ToolType::chamfer:
+            apt.cornerCenterRadial = glm::clamp(shape.tipRadius, 0.0f, radius);
+            apt.sideAngleDegrees = glm::clamp(shape.taperAngleDegrees, MIN_TAPER_ANGLE_DEGREES, 90.0f);
+            break;
+        case ToolType::drill: {
+            // Ϊֱһֱ쵽⾶Բǰ뾶Ϊ0
+            float bottom = 90.0f - 0.5f * glm::clamp(shape.pointAngleDegrees, 1.0f, 180.0f);
+            apt.bottomAngleDegrees = bottom;
+            apt.cornerCenterRadial = radius;
+            apt.cornerCenterAxial = radius * std::tan(glm::radians(bottom));
+            break;
+        }
+        case ToolType::flat:
+        default:
+            apt.cornerCenterRadial = radius;
+            break;
+    }
+    return apt;
+}
+
+CutterProfile::CutterProfile(const AptCutterParameters& apt)
+    : radius((std::max)(0.5f * apt.diameter, 1e-6f)),
+      apt_(apt) {
+    float bottom = glm::radians(apt.bottomAngleDegrees);
+    float side = glm::radians(apt.sideAngleDegrees);
+    bottomEnd_ = apt.cornerCenterRadial + apt.cornerRadius * std::sin(bottom);
+    sideStart_ = glm::vec2(apt.cornerCenterRadial + apt.cornerRadius * std::cos(side),
+                           apt.cornerCenterAxial - apt.cornerRadius * std::sin(side));
+    tanBottom_ = std::tan(bottom);
+    cylindricalSide_ = apt.sideAngleDegrees <= 0.0f;
+    sideRise_ = cylindricalSide_ ? 0.0f : std::cos(side) / std::sin(side);
+
+    // ƽȼһڵ߰뾶
+    const float step = radius * radius / TABLE_SIZE;
+    invStep_ = 1.0f / step;
+    heights_.resize(TABLE_SIZE + 1);
+    slopes_.resize(TABLE_SIZE + 1);
+    for (int i = 0; i <= TABLE_SIZE; ++i) {
+        float dist = std::sqrt(step * i);
+        heights_[i] = exactHeightAt(dist);
+        slopes_[i] = exactSlopeAt(dist);
+    }
+}
+
+float CutterProfile::exactHeightAt(float dist) const {
+    if (dist <= bottomEnd_) {
+        return dist * tanBottom_;
+    }
+    if (dist <= sideStart_.x) {
+        float dx = dist - apt_.cornerCenterRadial;
+        float r = apt_.cornerRadius;
+        return apt_.cornerCenterAxial - std::sqrt((std::max)(r * r - dx * dx, 0.0f));
+    }
+    if (cylindricalSide_) {
+        // ԲⲻڵߡaptParameters ֻڲλڵ߰뾶ʱԲ棨ƽסͷţǡͷ
+        // ֻߵֱӹĲ뱣֤ cornerCenterRadial + cornerRadius ڵ߰뾶
+        return sideStart_.y;
+    }
+    return sideStart_.y + (dist - sideStart_.x) * sideRise_;
+}
+
+float CutterProfile::exactSlopeAt(float dist) const {
+    if (dist <= bottomEnd_) {
+        return tanBottom_;
+    }
+    if (dist <= sideStart_.x) {
+        float dx = dist - apt_.cornerCenterRadial;
+        float r = apt_.cornerRadius;
+        float dy = std::sqrt((std::max)(r * r - dx * dx, 0.0f));
+        return (dx >= dy * MAX_SLOPE) ? MAX_SLOPE : dx / dy;
+    }
+    return cylindricalSide_ ? MAX_SLOPE : (std::min)(sideRise_, MAX_SLOPE);
+}
@@ -0,0 +1,99 @@
+#ifndef CUTTER_PROFILE_H
+#define CUTTER_PROFILE_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "tool_profile.h"
+
+// APT ĵ߲ȵλëͬǶΪȣڹĽϣԵΪԭ㡢
+// ˮƽΪ ѡصΪ y±ɣ
+//       ӵˮƽнΪ bottomAngle ֱ
+//   Բ    Բ (cornerCenterRadial, cornerCenterAxial)뾶 cornerRadius ԲͲ
+//       뵶нΪ sideAngle ֱߣsideAngle Ϊ0ʱΪԲ
+// 뱣֤ԲУsideAngle Ϊ0ʱԲλ d / 2  APT  d, r, e, f, , £ֻӰ쵶ĵ h
+struct AptCutterParameters {
+    float diameter = 0.0f;           // d
+    float cornerRadius = 0.0f;       // r
+    float cornerCenterRadial = 0.0f; // e
+    float cornerCenterAxial = 0.0f;  // f
+    float bottomAngleDegrees = 0.0f; // 
+    float sideAngleDegrees = 0.0f;   // 
+};
+
+// ԡ뾶-߶ȡͨõߣ AptCutterParameters
+// ʱѵ±Եĸ߶Ⱥбʰ൶ˮƽƽȼɱ
+// heightAt ֻһγ˷ԲֵҪκ״𶥵㿪ƽ׵ͬ
+// 㵶״ԵĽӿڣ tool_profile.hֱʵ
+class CutterProfile {
+public:
+    // ұƽʱˣԲ׶⸽ԼΪ radius * б / (4 * sqrt(TABLE_SIZE))
+    // Բ⾶ֱʱһ䣨Լ radius / (2 * TABLE_SIZE)ڲֵƫߣж
+    static constexpr int TABLE_SIZE = 4096;
+
+    // ͺ״ APT radius Ϊ߰뾶ֱһ룩
+    static AptCutterParameters aptParameters(const ToolShape& shape, float radius);
+
+    CutterProfile() : CutterProfile(AptCutterParameters{}) {}
+    explicit CutterProfile(const AptCutterParameters& apt);
+    CutterProfile(const ToolShape& shape, float radius) : CutterProfile(aptParameters(shape, radius)) {}
+
+    const AptCutterParameters& getAptParameters() const { return apt_; }
+
+    // ľȷ߶Ⱥбʣdy/dѣdist Ϊˮƽ
+    float exactHeightAt(float dist) const;
+    float exactSlopeAt(float dist) const;
+
+    // --- ״Խӿ ---
+    float radius; // ߰뾶ֱһ룩
+
+    float heightAt(float distSquared) const {
+        float t = distSquared * invStep_;
+        int i = (std::min)(static_cast<int>(t), TABLE_SIZE - 1);
+        float frac = t - static_cast<float>(i);
+        return heights_[i] + (heights_[i + 1] - heights_[i]) * frac;
+    }
+    // ˮƽĲƽ׵ָͬϷಿȡ߱ⷨߣͷķԼһ
+    glm::vec3 normalAt(const glm::vec3& offset) const {
+        float distSquared = offset.x * offset.x + offset.z * offset.z;
+        float t = (std::min)(distSquared, radius * radius) * invStep_;
+        int i = (std::min)(static_cast<int>(t), TABLE_SIZE - 1);
+        float slope = slopes_[i] + (slopes_[i + 1] - slopes_[i]) * (t - static_cast<float>(i));
+        if (slope <= 1e-6f || distSquared <= 0.0f) {
+            return glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        float scale = slope / std::sqrt(distSquared);
+        return glm::normalize(glm::vec3(offset.x * scale, -1.0f, offset.z * scale));
+    }
+    float lowestAlong(float slope, float perpDistSquared, float halfChord) const {
+        return lowestAlongConvex(*this, slope, perpDistSquared, halfChord);
+    }
+
+private:
+    AptCutterParameters apt_;
+    //  APT ķֶλãԲǵе  ꣬Բе
+    float bottomEnd_;
+    glm::vec2 sideStart_;
+    float tanBottom_;
+    bool cylindricalSide_; // ΪԲ棨sideAngle Ϊ0
+    float sideRise_;       // Բ׶ÿλˮƽĸ߶
+
+    float invStep_;              // TABLE_SIZE / radius^2
+    std::vector<float> heights_; // TABLE_SIZE + 1 
+    std::vector<float> slopes_;
+};
+
+// ѡ񵶾״Բ fn(profile) fn Ľÿֻжһεͣ
+// ƽ׵ͷʹýʽ tool_profile.hֱʹ cutter Ĳұ
+template <typename Fn>
+decltype(auto) dispatchToolProfile(ToolType type, const CutterProfile& cutter, Fn&& fn) {
+    switch (type) {
+        case ToolType::flat:
+            return fn(FlatToolProfile{ cutter.radius });
+        case ToolType::ball:
+            return fn(BallToolProfile{ cutter.radius });
+        default:
+            return fn(cutter);
+    }
+}
+
+#endif // CUTTER_PROFILE_H
@@ -0,0 +1,246 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    struct FrameRecord {
+        int64_t phaseNs[FrameProfiler::PHASE_COUNT];
+        int64_t frameNs;
+    };
+
+    std::atomic<bool> g_recording(false);
+    std::atomic<int64_t> g_phaseAccumulator[FrameProfiler::PHASE_COUNT];
+    FrameProfiler::Clock::time_point g_frameStart;
+    bool g_frameStarted = false;
+
+    // ֻȾ̷߳
+    std::vector<FrameRecord> g_frames; // λ
+    size_t g_framesWritten = 0;
+
+    // trace ¼ÿ߳һ߳ͬһ
+    // ÿ߳ౣ¼ÿ¼40ֽڣԼ40MB¼
+    const size_t MAX_TRACE_EVENTS_PER_THREAD = size_t(1) << 20;
+    struct TraceEvent {
+        const char* name;
+        int64_t startNs; //  g_traceOriginNs
+        int64_t durationNs;
+        int64_t counterValue;
+        bool isCounter;
+    };
+    struct ThreadTrace {
+        std::mutex mutex; // ֻдļʱ¼߳̾
+        std::vector<TraceEvent> events;
+        size_t droppedEvents = 0;
+        std::string name;
+        int tid = 0;
+    };
+
+    bool g_traceRequested = false;
+    std::atomic<bool> g_tracing(false);
+    // ʱӼԪ߳ g_tracingrelease/acquire֮ȡдȡݾ
+    std::atomic<int64_t> g_traceOriginNs(0);
+    std::mutex g_threadsMutex;
+    std::vector<std::unique_ptr<ThreadTrace>> g_threads; // ߳̽ŲḴ
+    thread_local ThreadTrace* t_threadTrace = nullptr;
+
+    ThreadTrace& currentThreadTrace() {
+        if (!t_threadTrace) {
+            std::lock_guard<std::mutex> lock(g_threadsMutex);
+            g_threads.push_back(std::make_unique<ThreadTrace>());
+            t_threadTrace = g_threads.back().get();
+            t_threadTrace->tid = static_cast<int>(g_threads.size());
+            t_threadTrace->name = "Thread " + std::to_string(t_threadTrace->tid);
+        }
+        return *t_threadTrace;
+    }
+
+    void pushTraceEvent(const TraceEvent& event) {
+        ThreadTrace& trace = currentThreadTrace();
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        if (trace.events.size() >= MAX_TRACE_EVENTS_PER_THREAD) {
+            ++trace.droppedEvents;
+            return;
+        }
+        trace.events.push_back(event);
+    }
+
+    int64_t sinceTraceOrigin(FrameProfiler::Clock::time_point time) {
+        int64_t timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        return timeNs - g_traceOriginNs.load(std::memory_order_relaxed);
+    }
+
+    // ȷλvalues 
+    double percentileMs(const std::vector<int64_t>& values, double p) {
+        size_t rank = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+        return values[rank] / 1e6;
+    }
+}
+
+void FrameProfiler::startRecording() {
+    g_frames.assign(RING_CAPACITY, FrameRecord{});
+    g_framesWritten = 0;
+    for (std::atomic<int64_t>& accumulator : g_phaseAccumulator) {
+        accumulator.store(0);
+    }
+    g_frameStarted = false;
+    if (g_traceRequested) {
+        std::lock_guard<std::mutex> lock(g_threadsMutex);
+        for (std::unique_ptr<ThreadTrace>& trace : g_threads) {
+            std::lock_guard<std::mutex> traceLock(trace->mutex);
+            trace->events.clear();
+            trace->droppedEvents = 0;
+        }
+        g_traceOriginNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(),
+                              std::memory_order_relaxed);
+    }
+    g_tracing.store(g_traceRequested, std::memory_order_release);
+    g_recording = true;
+}
+
+void FrameProfiler::stopRecording() {
+    g_recording = false;
+    g_tracing = false;
+}
+
+bool FrameProfiler::isRecording() {
+    return g_recording.load(std::memory_order_relaxed);
+}
+
+void FrameProfiler::beginFrame() {
+    if (!isRecording()) {
+        return;
+    }
+    g_frameStart = Clock::now();
+    g_frameStarted = true;
+}
+
+void FrameProfiler::endFrame() {
+    if (!isRecording() || !g_frameStarted) {
+        return;
+    }
+    FrameRecord& record = g_frames[g_framesWritten % RING_CAPACITY];
+    Clock::time_point frameEnd = Clock::now();
+    record.frameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(frameEnd - g_frameStart).count();
+    if (isTracing()) {
+        traceSpan("Frame", g_frameStart, frameEnd);
+    }
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        record.phaseNs[phase] = g_phaseAccumulator[phase].exchange(0, std::memory_order_relaxed);
+    }
+    ++g_framesWritten;
+}
+
+void FrameProfiler::addSample(Phase phase, int64_t nanoseconds) {
+    g_phaseAccumulator[phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void FrameProfiler::setTraceCapture(bool enabled) {
+    g_traceRequested = enabled;
+}
+
+bool FrameProfiler::isTracing() {
+    return g_tracing.load(std::memory_order_acquire);
+}
+
+void FrameProfiler::setThreadName(const char* name) {
+    ThreadTrace& trace = currentThreadTrace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.name = name;
+}
+
+void FrameProfiler::traceCounter(const char* name, int64_t value) {
+    if (!isTracing()) {
+        return;
+    }
+    pushTraceEvent({ name, sinceTraceOrigin(Clock::now()), 0, value, true });
+}
+
+void FrameProfiler::traceSpan(const char* name, Clock::time_point start, Clock::time_point end) {
+    pushTraceEvent({ name, sinceTraceOrigin(start), std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), 0, false });
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> std::ofstream& {
+        file << (first ? "" : ",\n");
+        first = false;
+        return file;
+    };
+
+    std::lock_guard<std::mutex> lock(g_threadsMutex);
+    for (std::unique_ptr<ThreadTrace>& trace : g_threads) {
+        std::lock_guard<std::mutex> traceLock(trace->mutex);
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->tid
+                    << ",\"args\":{\"name\":\"" << trace->name << "\"}}";
+        for (const TraceEvent& event : trace->events) {
+            // trace_event ʱ䵥λΪ΢
+            if (event.isCounter) {
+                separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"ts\":" << event.startNs / 1000.0
+                            << ",\"pid\":1,\"tid\":" << trace->tid << ",\"args\":{\"value\":" << event.counterValue << "}}";
+            } else {
+                separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":" << event.startNs / 1000.0
+                            << ",\"dur\":" << event.durationNs / 1000.0 << ",\"pid\":1,\"tid\":" << trace->tid << "}";
+            }
+        }
+        if (trace->droppedEvents > 0) {
+            // ¼Ϊڸ߳һ¼λ
+            separator() << "{\"name\":\"droppedTraceEvents\",\"ph\":\"C\",\"ts\":" << trace->events.back().startNs / 1000.0
+                        << ",\"pid\":1,\"tid\":" << trace->tid << ",\"args\":{\"value\":" << trace->droppedEvents << "}}";
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+const char* FrameProfiler::phaseName(Phase phase) {
+    static const char* const names[PHASE_COUNT] = {
+        "Input", "PathUpdate", "QuadtreeQuery", "CutKernel", "VboUpload", "Draw", "Text", "Swap"
+    };
+    return names[phase];
+}
+
+std::string FrameProfiler::report() {
+    std::stringstream report;
+    const size_t frameCount = (std::min)(g_framesWritten, RING_CAPACITY);
+    if (frameCount == 0) {
+        report << "No frame phases were recorded." << std::endl;
+        return report.str();
+    }
+
+    report << std::fixed << std::setprecision(3);
+    report << "Frame phases over the last " << frameCount << " frames (ms):" << std::endl;
+    report << std::left << std::setw(16) << "Phase" << std::right
+           << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+
+    std::vector<int64_t> values(frameCount);
+    auto printRow = [&](const char* name) {
+        std::sort(values.begin(), values.end());
+        report << std::left << std::setw(16) << name << std::right
+               << std::setw(10) << percentileMs(values, 0.50) << std::setw(10) << percentileMs(values, 0.95)
+               << std::setw(10) << percentileMs(values, 0.99) << std::setw(10) << values.back() / 1e6 << std::endl;
+    };
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        for (size_t i = 0; i < frameCount; ++i) {
+            values[i] = g_frames[i].phaseNs[phase];
+        }
+        printRow(phaseName(static_cast<Phase>(phase)));
+    }
+    for (size_t i = 0; i < frameCount; ++i) {
+        values[i] = g_frames[i].frameNs;
+    }
+    printRow("Frame");
+    return report.str();
+}
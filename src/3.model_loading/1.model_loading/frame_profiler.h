@@ -0,0 +1,102 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// ֽ֡׶εĺʱͳơ FrameProfiler::Scope ʱʱۼӵǰ֡ӦĽ׶Σ
+// Ⱦ߳ÿ֡ʱ endFrame()ѱ֡׶κʱд뻷λ
+// ֻڼ¼ڼ䣨R ʼ/ֹͣŻȡʱӣֹͣʱ׶ε p50/p95/p99/max
+// ʱ̡̣̳߳߳߳أǵĺʱȾ̵߳ǰڽеһ֡
+//  trace ɼÿʱͼᰴ̼߳¼Ϊ¼ɵΪ Chrome trace_event JSON
+//  chrome://tracing  Perfetto в鿴еʱߡÿ߳ౣԼһ¼
+// ¼ droppedTraceEvents д trace
+class FrameProfiler {
+public:
+    enum Phase {
+        Input,
+        PathUpdate,
+        // ռѯֻͳɺѡĲѯSoA ѯǰ queryRect
+        // MillingManager  visitRange / visitRect Ҷɨֱʱɺѡ飬
+        // ѯ֯һ޷ֿʱѯʱ CutKernel׶Ϊ0
+        QuadtreeQuery,
+        CutKernel,
+        VboUpload,
+        Draw,
+        Text,
+        Swap,
+        PHASE_COUNT
+    };
+
+    using Clock = std::chrono::steady_clock; // ʱ
+
+    // λ֡󸲸֡
+    static constexpr size_t RING_CAPACITY = size_t(1) << 16;
+
+    static void startRecording();
+    static void stopRecording();
+    static bool isRecording();
+
+    // Ⱦ̣߳һ֡Ŀʼ
+    static void beginFrame();
+    static void endFrame();
+
+    static void addSample(Phase phase, int64_t nanoseconds);
+
+    // trace ɼ startRecording() ֮ǰã¼ڼЧ
+    static void setTraceCapture(bool enabled);
+    static bool isTracing();
+    // Ϊǰ߳ trace  "Render""Simulation"
+    static void setThreadName(const char* name);
+    // ¼һ¼name Ϊַ
+    static void traceCounter(const char* name, int64_t value);
+    static void traceSpan(const char* name, Clock::time_point start, Clock::time_point end);
+    // ѱμ¼¼д trace_event JSONʧʱ false
+    static bool writeChromeTrace(const std::string& filename);
+
+    // ¼ڼ׶μ֡ʱķλ
+    static std::string report();
+    static const char* phaseName(Phase phase);
+
+    // ʱʱʼʱѺʱ phase
+    // ֹʱκν׶Σֻ trace м¼һ䣨name Ϊַ
+    class Scope {
+    public:
+        explicit Scope(Phase phase) : phase_(phase), name_(nullptr), active_(isRecording()) {
+            if (active_) {
+                start_ = Clock::now();
+            }
+        }
+        explicit Scope(const char* traceName) : phase_(PHASE_COUNT), name_(traceName), active_(isTracing()) {
+            if (active_) {
+                start_ = Clock::now();
+            }
+        }
+        ~Scope() { stop(); }
+
+        // ǰʱ֮ظ
+        void stop() {
+            if (active_) {
+                Clock::time_point end = Clock::now();
+                if (phase_ != PHASE_COUNT) {
+                    addSample(phase_, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count());
+                }
+                if (isTracing()) {
+                    traceSpan(name_ ? name_ : phaseName(phase_), start_, end);
+                }
+                active_ = false;
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Phase phase_;
+        const char* name_;
+        bool active_;
+        Clock::time_point start_;
+    };
+};
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,287 @@
+#include "gcode_reader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <glm/gtc/constants.hpp>
+#include "mapped_file.h"
+
+namespace {
+
+    // ÿӳļС Windows ӳȣ64KBͳҳС
+    constexpr size_t CHUNK_BYTES = size_t(16) << 20;
+    // G0 ƶʹõĽ/ӣ
+    constexpr double RAPID_FEED_MM_PER_MIN = 5000.0;
+    // ԲϸֵҸף
+    constexpr double ARC_TOLERANCE_MM = 0.01;
+
+    //  [p, end) ͷʮɴźС㣩ɹʱ p Ƶ֮
+    bool parseNumber(const char*& p, const char* end, double& value) {
+        const char* s = p;
+        while (s < end && (*s == ' ' || *s == '\t')) ++s;
+        bool negative = false;
+        if (s < end && (*s == '+' || *s == '-')) {
+            negative = (*s == '-');
+            ++s;
+        }
+        double result = 0.0;
+        bool hasDigits = false;
+        while (s < end && *s >= '0' && *s <= '9') {
+            result = result * 10.0 + (*s - '0');
+            hasDigits = true;
+            ++s;
+        }
+        if (s < end && *s == '.') {
+            ++s;
+            double scale = 0.1;
+            while (s < end && *s >= '0' && *s <= '9') {
+                result += (*s - '0') * scale;
+                scale *= 0.1;
+                hasDigits = true;
+                ++s;
+            }
+        }
+        if (!hasDigits) return false;
+        value = negative ? -result : result;
+        p = s;
+        return true;
+    }
+
+    // Gģ̬״̬뺽굥λΪ
+    class GCodeInterpreter {
+    public:
+        template <typename EmitFn>
+        void executeLine(const char* p, const char* end, EmitFn&& emit) {
+            bool hasAxis[3] = { false, false, false };
+            double axis[3] = { 0.0, 0.0, 0.0 };
+            double offset[3] = { 0.0, 0.0, 0.0 }; // IJK
+            bool hasOffset = false;
+            bool hasRadius = false;
+            double radius = 0.0;
+            bool hasFeed = false;
+            double feed = 0.0;
+
+            // ȶٻ㵥λͬһ G20/G21 ֮ʱͬԸеЧ
+            while (p < end) {
+                char c = static_cast<char>(std::toupper(static_cast<unsigned char>(*p)));
+                if (c == ';') break; // βע
+                if (c == '(') {      // ע
+                    while (p < end && *p != ')') ++p;
+                    if (p < end) ++p;
+                    continue;
+                }
+                if (c < 'A' || c > 'Z') {
+                    ++p;
+                    continue;
+                }
+                ++p;
+                double value;
+                if (!parseNumber(p, end, value)) continue; // ֵĸ
+                switch (c) {
+                case 'G': executeG(static_cast<int>(std::lround(value * 10.0))); break;
+                case 'X': hasAxis[0] = true; axis[0] = value; break;
+                case 'Y': hasAxis[1] = true; axis[1] = value; break;
+                case 'Z': hasAxis[2] = true; axis[2] = value; break;
+                case 'I': hasOffset = true; offset[0] = value; break;
+                case 'J': hasOffset = true; offset[1] = value; break;
+                case 'K': hasOffset = true; offset[2] = value; break;
+                case 'R': hasRadius = true; radius = value; break;
+                case 'F': hasFeed = true; feed = value; break;
+                default: break; // NMTS 뵶˶޹
+                }
+            }
+
+            for (int a = 0; a < 3; ++a) {
+                axis[a] *= unitScale_;
+                offset[a] *= unitScale_;
+            }
+            radius *= unitScale_;
+            if (hasFeed) feed_ = feed * unitScale_;
+
+            // ֻ I/J/K Բûյ꣬յ㼴㣨Բ
+            const bool isArc = (motion_ == 2 || motion_ == 3);
+            if (!hasAxis[0] && !hasAxis[1] && !hasAxis[2] && !(isArc && hasOffset)) return;
+            double target[3];
+            for (int a = 0; a < 3; ++a) {
+                target[a] = hasAxis[a] ? (absolute_ ? axis[a] : position_[a] + axis[a]) : position_[a];
+            }
+
+            if (isArc) {
+                emitArc(target, offset, hasRadius, radius, emit);
+            } else {
+                emit(target, motion_ == 0 ? RAPID_FEED_MM_PER_MIN : feed_);
+            }
+            std::copy(target, target + 3, position_);
+        }
+
+    private:
+        // code Ϊ G ֵ10 G1 -> 10G90.1 -> 901
+        void executeG(int code) {
+            switch (code) {
+            case 0: motion_ = 0; break;
+            case 10: motion_ = 1; break;
+            case 20: motion_ = 2; break;
+            case 30: motion_ = 3; break;
+            case 170: plane_[0] = 0; plane_[1] = 1; plane_[2] = 2; break; // XY
+            case 180: plane_[0] = 2; plane_[1] = 0; plane_[2] = 1; break; // ZX
+            case 190: plane_[0] = 1; plane_[1] = 2; plane_[2] = 0; break; // YZ
+            case 200: unitScale_ = 25.4; break;
+            case 210: unitScale_ = 1.0; break;
+            case 900: absolute_ = true; break;
+            case 910: absolute_ = false; break;
+            default: break;
+            }
+        }
+
+        template <typename EmitFn>
+        void emitArc(const double target[3], const double offset[3], bool hasRadius, double radius, EmitFn&& emit) {
+            const int a0 = plane_[0], a1 = plane_[1], linear = plane_[2];
+            const bool clockwise = (motion_ == 2);
+            double dx = target[a0] - position_[a0];
+            double dy = target[a1] - position_[a1];
+            double i = offset[a0], j = offset[a1];
+
+            if (hasRadius) {
+                // R ʽҳԲģR Ϊʾ180ȵԲ
+                double chordSq = dx * dx + dy * dy;
+                double hSq = 4.0 * radius * radius - chordSq;
+                if (chordSq == 0.0 || hSq < 0.0) {
+                    emit(target, feed_); // ޷Բֱߴ
+                    return;
+                }
+                double h = -std::sqrt(hSq) / std::sqrt(chordSq);
+                if (!clockwise) h = -h;
+                if (radius < 0.0) h = -h;
+                i = 0.5 * (dx - dy * h);
+                j = 0.5 * (dy + dx * h);
+            }
+
+            double centerX = position_[a0] + i, centerY = position_[a1] + j;
+            double r = std::sqrt(i * i + j * j);
+            double startAngle = std::atan2(-j, -i);
+            double sweep = std::atan2(target[a1] - centerY, target[a0] - centerX) - startAngle;
+            const double twoPi = 2.0 * glm::pi<double>();
+            if (clockwise && sweep >= -1e-9) sweep -= twoPi;
+            if (!clockwise && sweep <= 1e-9) sweep += twoPi;
+
+            // ҸȷÿεԲĽ
+            double maxStep = glm::pi<double>() / 4.0;
+            if (r > ARC_TOLERANCE_MM) {
+                maxStep = (std::min)(maxStep, 2.0 * std::acos(1.0 - ARC_TOLERANCE_MM / r));
+            }
+            int segments = (std::max)(1, static_cast<int>(std::ceil(std::fabs(sweep) / maxStep)));
+
+            double point[3];
+            for (int s = 1; s < segments; ++s) {
+                double t = static_cast<double>(s) / segments;
+                double angle = startAngle + sweep * t;
+                point[a0] = centerX + r * std::cos(angle);
+                point[a1] = centerY + r * std::sin(angle);
+                point[linear] = position_[linear] + (target[linear] - position_[linear]) * t; // 岹
+                emit(point, feed_);
+            }
+            emit(target, feed_); // һֱյ㣬ۻ
+        }
+
+        double position_[3] = { 0.0, 0.0, 0.0 };
+        double feed_ = 0.0;        // /ӣ0 ʾδָ
+        double unitScale_ = 1.0;   // 뵥λ
+        bool absolute_ = true;
+        int motion_ = 0;
+        int plane_[3] = { 0, 1, 2 }; // Բƽʹֱ
+    };
+}
+
+GCodeToolpathReader::GCodeToolpathReader(const std::string& path, float sceneUnitsPerMm)
+    : path_(path),
+      sceneUnitsPerMm_(sceneUnitsPerMm),
+      queue_(QUEUE_BATCHES),
+      parserDone_(false),
+      failed_(false),
+      linesParsed_(0) {
+    parserThread_ = std::thread(&GCodeToolpathReader::parseFile, this);
+}
+
+GCodeToolpathReader::~GCodeToolpathReader() {
+    queue_.close(); // ѿ push ϵĽ߳
+    if (parserThread_.joinable()) {
+        parserThread_.join();
+    }
+}
+
+bool GCodeToolpathReader::tryPopBatch(std::vector<ToolpathWaypoint>& batch) {
+    return queue_.tryPop(batch);
+}
+
+void GCodeToolpathReader::parseFile() {
+    MappedFile file;
+    if (!file.open(path_)) {
+        std::cerr << "GCodeToolpathReader: Failed to open " << path_ << std::endl;
+        failed_ = true;
+        parserDone_ = true;
+        return;
+    }
+
+    GCodeInterpreter interpreter;
+    std::vector<ToolpathWaypoint> batch;
+    batch.reserve(BATCH_WAYPOINTS);
+    bool stopped = false;
+    const float scale = sceneUnitsPerMm_;
+    auto emit = [&](const double position[3], double feedMmPerMin) {
+        ToolpathWaypoint waypoint;
+        waypoint.position = glm::vec3(static_cast<float>(position[0]) * scale,
+                                      static_cast<float>(position[2]) * scale,
+                                      -static_cast<float>(position[1]) * scale);
+        waypoint.speed = static_cast<float>(feedMmPerMin / 60.0) * scale;
+        batch.push_back(waypoint);
+        if (batch.size() == BATCH_WAYPOINTS) {
+            stopped = stopped || !queue_.push(std::move(batch));
+            batch.clear();
+            batch.reserve(BATCH_WAYPOINTS);
+        }
+    };
+
+    size_t lines = 0;
+    std::string carry; // Խӳ
+    for (size_t chunkStart = 0; chunkStart < file.size() && !stopped; chunkStart += CHUNK_BYTES) {
+        size_t chunkLength = (std::min)(CHUNK_BYTES, file.size() - chunkStart);
+        const char* data = file.map(chunkStart, chunkLength);
+        if (!data) {
+            std::cerr << "GCodeToolpathReader: Failed to map " << path_ << " at offset " << chunkStart << std::endl;
+            failed_ = true;
+            break;
+        }
+        const char* end = data + chunkLength;
+        const char* lineStart = data;
+        while (lineStart < end && !stopped) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart));
+            if (!lineEnd) {
+                carry.append(lineStart, end);
+                break;
+            }
+            if (carry.empty()) {
+                interpreter.executeLine(lineStart, lineEnd, emit);
+            } else {
+                carry.append(lineStart, lineEnd);
+                interpreter.executeLine(carry.data(), carry.data() + carry.size(), emit);
+                carry.clear();
+            }
+            lineStart = lineEnd + 1;
+            if ((++lines & 0xFFFF) == 0) {
+                linesParsed_ = lines;
+            }
+        }
+    }
+    file.unmap();
+    if (!carry.empty() && !stopped) {
+        interpreter.executeLine(carry.data(), carry.data() + carry.size(), emit);
+        ++lines;
+    }
+    if (!batch.empty() && !stopped) {
+        queue_.push(std::move(batch));
+    }
+    linesParsed_ = lines;
+    parserDone_ = true;
+}
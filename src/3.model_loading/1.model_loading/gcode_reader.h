@@ -0,0 +1,57 @@
+#ifndef GCODE_READER_H
+#define GCODE_READER_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounded_queue.h"
+
+// ·ϵһ
+struct ToolpathWaypoint {
+    glm::vec3 position; // ڳϵеλãG X -> xZ -> yY -> -z
+    float speed;        // úĽٶȣλ/룩<= 0 ʾʹ PathManager Ĭٶ
+};
+
+// ISO G뵶·ȡ֧ G0/G1 ֱߡG2/G3 ԲI/J/K  R ʽҸϸ֣
+// F G90/G91G20/G21G17/G18/G19
+// ļ̶СĿڴӳ䣬ɺ̨߳̽㰴нУ
+// ˼еCAMҲֻռù̶ڴ棬ҽһͿԿʼ档
+class GCodeToolpathReader {
+public:
+    // ÿ໺
+    static constexpr size_t BATCH_WAYPOINTS = 4096;
+    static constexpr size_t QUEUE_BATCHES = 16;
+
+    // sceneUnitsPerMm: 1 ׶Ӧĳȣʼں̨
+    GCodeToolpathReader(const std::string& path, float sceneUnitsPerMm);
+    // ֹͣȴ̨߳˳
+    ~GCodeToolpathReader();
+
+    GCodeToolpathReader(const GCodeToolpathReader&) = delete;
+    GCodeToolpathReader& operator=(const GCodeToolpathReader&) = delete;
+
+    // ȡһ㣬ǰûнõĺʱ false
+    bool tryPopBatch(std::vector<ToolpathWaypoint>& batch);
+
+    // ļȫҺȫȡ
+    bool isFinished() const { return parserDone_.load() && queue_.empty(); }
+    // ļ޷򿪻ӳ
+    bool hasError() const { return failed_.load(); }
+    size_t getLinesParsed() const { return linesParsed_.load(); }
+
+private:
+    void parseFile();
+
+    std::string path_;
+    float sceneUnitsPerMm_;
+    BoundedQueue<std::vector<ToolpathWaypoint>> queue_;
+    std::atomic<bool> parserDone_;
+    std::atomic<bool> failed_;
+    std::atomic<size_t> linesParsed_;
+    std::thread parserThread_;
+};
+
+#endif // GCODE_READER_H
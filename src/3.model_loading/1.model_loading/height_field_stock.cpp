@@ -0,0 +1,150 @@
+#include "height_field_stock.h"
+#include <limits>
+
+namespace {
+    // ÿв뵽 16  float64 ֽڣ֤ÿһеʼַж
+    constexpr size_t ROW_ALIGNMENT_FLOATS = 16;
+}
+
+HeightFieldStock::HeightFieldStock(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                                   int resolutionX, int resolutionZ,
+                                   float initialHeight, float baseHeight)
+    : minXZ_(minXZ),
+      maxXZ_(maxXZ),
+      resX_((std::max)(resolutionX, 2)),
+      resZ_((std::max)(resolutionZ, 2)),
+      baseHeight_(baseHeight),
+      dirtyRowMin_(std::numeric_limits<int>::max()),
+      dirtyRowMax_(-1) {
+    cellSize_ = glm::vec2((maxXZ_.x - minXZ_.x) / (resX_ - 1),
+                          (maxXZ_.y - minXZ_.y) / (resZ_ - 1));
+    rowStride_ = (static_cast<size_t>(resX_) + ROW_ALIGNMENT_FLOATS - 1) / ROW_ALIGNMENT_FLOATS * ROW_ALIGNMENT_FLOATS;
+    heights_.assign(rowStride_ * resZ_, initialHeight);
+    colors_.assign(static_cast<size_t>(resX_) * resZ_, glm::vec3(0.5f, 0.5f, 0.5f));
+}
+
+glm::vec3 HeightFieldStock::getCellPosition(int ix, int iz) const {
+    return glm::vec3(minXZ_.x + ix * cellSize_.x, getHeight(ix, iz), minXZ_.y + iz * cellSize_.y);
+}
+
+bool HeightFieldStock::cellRange(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                                 int& ix0, int& ix1, int& iz0, int& iz1) const {
+    ix0 = (std::max)(0, static_cast<int>(std::ceil((minXZ.x - minXZ_.x) / cellSize_.x)));
+    ix1 = (std::min)(resX_ - 1, static_cast<int>(std::floor((maxXZ.x - minXZ_.x) / cellSize_.x)));
+    iz0 = (std::max)(0, static_cast<int>(std::ceil((minXZ.y - minXZ_.y) / cellSize_.y)));
+    iz1 = (std::min)(resZ_ - 1, static_cast<int>(std::floor((maxXZ.y - minXZ_.y) / cellSize_.y)));
+    return ix0 <= ix1 && iz0 <= iz1;
+}
+
+void HeightFieldStock::markRowsDirty(int iz0, int iz1) {
+    dirtyRowMin_ = (std::min)(dirtyRowMin_, iz0);
+    dirtyRowMax_ = (std::max)(dirtyRowMax_, iz1);
+}
+
+glm::vec3 HeightFieldStock::computeNormal(int ix, int iz) const {
+    // Ĳ߶ݶȣ߽紦˻Ϊ
+    int xl = (std::max)(ix - 1, 0), xr = (std::min)(ix + 1, resX_ - 1);
+    int zl = (std::max)(iz - 1, 0), zr = (std::min)(iz + 1, resZ_ - 1);
+    float dhdx = (getHeight(xr, iz) - getHeight(xl, iz)) / ((xr - xl) * cellSize_.x);
+    float dhdz = (getHeight(ix, zr) - getHeight(ix, zl)) / ((zr - zl) * cellSize_.y);
+    return glm::normalize(glm::vec3(-dhdx, 1.0f, -dhdz));
+}
+
+Mesh HeightFieldStock::buildMesh(VertexLayout layout) const {
+    vector<Vertex> vertices;
+    vector<unsigned int> indices;
+    const size_t topCount = static_cast<size_t>(resX_) * resZ_;
+    vertices.reserve(topCount + 4 * static_cast<size_t>(resX_ + resZ_));
+
+    // ϱ棺ÿһ㣬±Ϊ iz * resX + ix
+    for (int iz = 0; iz < resZ_; ++iz) {
+        for (int ix = 0; ix < resX_; ++ix) {
+            Vertex vertex{};
+            vertex.Position = getCellPosition(ix, iz);
+            vertex.Normal = computeNormal(ix, iz);
+            vertex.Color = colors_[static_cast<size_t>(iz) * resX_ + ix];
+            vertices.push_back(vertex);
+        }
+    }
+    for (int iz = 0; iz + 1 < resZ_; ++iz) {
+        for (int ix = 0; ix + 1 < resX_; ++ix) {
+            unsigned int i0 = iz * resX_ + ix;
+            unsigned int i1 = i0 + 1;
+            unsigned int i2 = i0 + resX_;
+            unsigned int i3 = i2 + 1;
+            indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+        }
+    }
+
+    // ܲڣر߽ÿһԣءأ㣬ظ߶ȸ߽
+    auto addSkirt = [&](int count, auto cellOf, const glm::vec3& normal) {
+        unsigned int first = static_cast<unsigned int>(vertices.size());
+        for (int k = 0; k < count; ++k) {
+            glm::ivec2 cell = cellOf(k);
+            Vertex top{};
+            top.Position = getCellPosition(cell.x, cell.y);
+            top.Normal = normal;
+            top.Color = glm::vec3(0.5f, 0.5f, 0.5f);
+            Vertex bottom = top;
+            bottom.Position.y = baseHeight_;
+            vertices.push_back(top);
+            vertices.push_back(bottom);
+            if (k + 1 < count) {
+                unsigned int t0 = first + 2 * k, b0 = t0 + 1, t1 = t0 + 2, b1 = t0 + 3;
+                indices.insert(indices.end(), { t0, b0, t1, t1, b0, b1 });
+            }
+        }
+    };
+    addSkirt(resX_, [&](int k) { return glm::ivec2(k, 0); },         glm::vec3(0.0f, 0.0f, -1.0f));
+    addSkirt(resX_, [&](int k) { return glm::ivec2(k, resZ_ - 1); }, glm::vec3(0.0f, 0.0f, 1.0f));
+    addSkirt(resZ_, [&](int k) { return glm::ivec2(0, k); },         glm::vec3(-1.0f, 0.0f, 0.0f));
+    addSkirt(resZ_, [&](int k) { return glm::ivec2(resX_ - 1, k); }, glm::vec3(1.0f, 0.0f, 0.0f));
+
+    return Mesh(vertices, indices, vector<Texture>(), layout);
+}
+
+bool HeightFieldStock::updateMesh(Mesh& mesh) {
+    if (dirtyRowMax_ < dirtyRowMin_) {
+        return false;
+    }
+    const size_t topCount = static_cast<size_t>(resX_) * resZ_;
+    if (mesh.vertices.size() < topCount) {
+        return false; //  buildMesh() ɵ
+    }
+
+    // УдطΧҪչһ
+    int rowBegin = (std::max)(dirtyRowMin_ - 1, 0);
+    int rowEnd = (std::min)(dirtyRowMax_ + 1, resZ_ - 1);
+    for (int iz = rowBegin; iz <= rowEnd; ++iz) {
+        Vertex* vertexRow = &mesh.vertices[static_cast<size_t>(iz) * resX_];
+        const glm::vec3* colorRow = &colors_[static_cast<size_t>(iz) * resX_];
+        for (int ix = 0; ix < resX_; ++ix) {
+            vertexRow[ix].Position.y = getHeight(ix, iz);
+            vertexRow[ix].Normal = computeNormal(ix, iz);
+            vertexRow[ix].Color = colorRow[ix];
+        }
+    }
+    mesh.markVerticesDirty(static_cast<size_t>(rowBegin) * resX_, static_cast<size_t>(rowEnd - rowBegin + 1) * resX_);
+
+    // ض㰴 buildMesh() е˳ϱ涥֮
+    if (skirtCells_.empty()) {
+        for (int k = 0; k < resX_; ++k) skirtCells_.push_back(k);
+        for (int k = 0; k < resX_; ++k) skirtCells_.push_back((resZ_ - 1) * resX_ + k);
+        for (int k = 0; k < resZ_; ++k) skirtCells_.push_back(k * resX_);
+        for (int k = 0; k < resZ_; ++k) skirtCells_.push_back(k * resX_ + resX_ - 1);
+    }
+    if (mesh.vertices.size() >= topCount + 2 * skirtCells_.size()) {
+        for (size_t k = 0; k < skirtCells_.size(); ++k) {
+            int iz = static_cast<int>(skirtCells_[k] / resX_);
+            if (iz < rowBegin || iz > rowEnd) {
+                continue;
+            }
+            mesh.vertices[topCount + 2 * k].Position.y = mesh.vertices[skirtCells_[k]].Position.y;
+            mesh.markVertexDirty(topCount + 2 * k);
+        }
+    }
+
+    dirtyRowMin_ = std::numeric_limits<int>::max();
+    dirtyRowMax_ = -1;
+    return true;
+}
@@ -0,0 +1,169 @@
+#ifndef HEIGHT_FIELD_STOCK_H
+#define HEIGHT_FIELD_STOCK_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <learnopengl/mesh.h>
+#include "aligned_allocator.h"
+
+// һͳƣʵ뱻޸ĵ
+struct HeightFieldCutStats {
+    long long visited = 0;
+    long long modified = 0;
+};
+
+// ߶ȳZ-mapëXZƽϰ̶ֱʲĳܸ߶
+// ߶ݰŲж룬ߡɫڵͨУ
+// ֻ߸ǵӾΣ Mesh е Vertex ṹ塣
+class HeightFieldStock {
+public:
+    // minXZ / maxXZ: ëھֲϵXZƽķΧ
+    // resolutionX / resolutionZ: XZΪ2
+    // initialHeight: ëϱĳʼ߶
+    // baseHeight: ë±߶ȣڴֵ
+    HeightFieldStock(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                     int resolutionX, int resolutionZ,
+                     float initialHeight, float baseHeight);
+
+    int getResolutionX() const { return resX_; }
+    int getResolutionZ() const { return resZ_; }
+    float getHeight(int ix, int iz) const { return heights_[static_cast<size_t>(iz) * rowStride_ + ix]; }
+    //  (ix, iz) ëֲϵµλ
+    glm::vec3 getCellPosition(int ix, int iz) const;
+
+    //  toolTipLocal ĵprofile Ϊ״ԣ tool_profile.h
+    template <typename Profile>
+    HeightFieldCutStats cutPoint(const glm::vec3& toolTipLocal, const Profile& profile);
+
+    // ͨ [minXZ, maxXZ] ǵ㣬cutHeight(x, z, cutY) ظõǷڵ߷Χڣ
+    // ڸõеĸ߶ȡɨûרѭ
+    template <typename CutHeightFn>
+    HeightFieldCutStats cutRegion(const glm::vec2& minXZ, const glm::vec2& maxXZ, CutHeightFn&& cutHeight);
+
+    // ڻƵϱ + ܲڣҪЧ OpenGL ġ
+    // layout ΪԴеĶʽ
+    Mesh buildMesh(VertexLayout layout = VertexLayout::Full) const;
+    // ϴθдд buildMesh() ɵ񶥵㣨߶ȡߡɫ
+    // дĶҳλͼбǣ߸ϴ㻺塣дʱ true
+    bool updateMesh(Mesh& mesh);
+
+private:
+    // 귶Χ [first, last]ΧΪʱ false
+    bool cellRange(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                   int& ix0, int& ix1, int& iz0, int& iz1) const;
+    void markRowsDirty(int iz0, int iz1);
+    glm::vec3 computeNormal(int ix, int iz) const;
+
+    glm::vec2 minXZ_;
+    glm::vec2 maxXZ_;
+    int resX_;
+    int resZ_;
+    glm::vec2 cellSize_;
+    float baseHeight_;
+    size_t rowStride_;  // ÿʵռõ float 뵽
+
+    std::vector<float, AlignedAllocator<float>> heights_; // ߶ͨ
+    std::vector<glm::vec3> colors_;                        // ɫͨĵΪɫ
+    std::vector<unsigned int> skirtCells_;                 // ضӦ±꣨iz * resX + ix
+
+    int dirtyRowMin_;
+    int dirtyRowMax_;
+};
+
+template <typename Profile>
+HeightFieldCutStats HeightFieldStock::cutPoint(const glm::vec3& toolTipLocal, const Profile& profile) {
+    HeightFieldCutStats stats;
+    const float radius = profile.radius;
+    int ix0, ix1, iz0, iz1;
+    if (!cellRange(glm::vec2(toolTipLocal.x - radius, toolTipLocal.z - radius),
+                   glm::vec2(toolTipLocal.x + radius, toolTipLocal.z + radius),
+                   ix0, ix1, iz0, iz1)) {
+        return stats;
+    }
+
+    const float radius_squared = radius * radius;
+    // ߶ֻͲֵĵ㲻 modifiedѾдڵͬҪϴ
+    int writtenRowMin = iz1 + 1;
+    int writtenRowMax = iz0 - 1;
+    for (int iz = iz0; iz <= iz1; ++iz) {
+        float dz = minXZ_.y + iz * cellSize_.y - toolTipLocal.z;
+        float dz_squared = dz * dz;
+        if (dz_squared >= radius_squared) {
+            continue;
+        }
+        float* row = &heights_[static_cast<size_t>(iz) * rowStride_];
+        glm::vec3* colorRow = &colors_[static_cast<size_t>(iz) * resX_];
+        long long rowModified = 0;
+        bool rowWritten = false;
+        for (int ix = ix0; ix <= ix1; ++ix) {
+            float dx = minXZ_.x + ix * cellSize_.x - toolTipLocal.x;
+            float dist_xz_squared = dx * dx + dz_squared;
+            if (dist_xz_squared >= radius_squared) {
+                continue;
+            }
+            // ƽ׵ heightAt Ϊ0߶ᵽѭ
+            float cut_y = (std::max)(toolTipLocal.y + profile.heightAt(dist_xz_squared), baseHeight_);
+            if (row[ix] > cut_y) {
+                if (row[ix] - cut_y > 0.00001f) {
+                    ++rowModified;
+                }
+                row[ix] = cut_y;
+                colorRow[ix] = glm::vec3(1.0f, 1.0f, 1.0f);
+                rowWritten = true;
+            }
+        }
+        stats.visited += ix1 - ix0 + 1;
+        stats.modified += rowModified;
+        if (rowWritten) {
+            writtenRowMin = (std::min)(writtenRowMin, iz);
+            writtenRowMax = (std::max)(writtenRowMax, iz);
+        }
+    }
+    if (writtenRowMin <= writtenRowMax) {
+        markRowsDirty(writtenRowMin, writtenRowMax);
+    }
+    return stats;
+}
+
+template <typename CutHeightFn>
+HeightFieldCutStats HeightFieldStock::cutRegion(const glm::vec2& minXZ, const glm::vec2& maxXZ, CutHeightFn&& cutHeight) {
+    HeightFieldCutStats stats;
+    int ix0, ix1, iz0, iz1;
+    if (!cellRange(minXZ, maxXZ, ix0, ix1, iz0, iz1)) {
+        return stats;
+    }
+
+    int writtenRowMin = iz1 + 1;
+    int writtenRowMax = iz0 - 1;
+    for (int iz = iz0; iz <= iz1; ++iz) {
+        float* row = &heights_[static_cast<size_t>(iz) * rowStride_];
+        float z = minXZ_.y + iz * cellSize_.y;
+        for (int ix = ix0; ix <= ix1; ++ix) {
+            float x = minXZ_.x + ix * cellSize_.x;
+            float cutY;
+            ++stats.visited;
+            if (!cutHeight(x, z, cutY)) {
+                continue;
+            }
+            cutY = (std::max)(cutY, baseHeight_);
+            if (row[ix] > cutY) {
+                float old_y = row[ix];
+                row[ix] = cutY;
+                colors_[static_cast<size_t>(iz) * resX_ + ix] = glm::vec3(1.0f, 1.0f, 1.0f);
+                writtenRowMin = (std::min)(writtenRowMin, iz);
+                writtenRowMax = (std::max)(writtenRowMax, iz);
+                if (std::abs(old_y - cutY) > 0.00001f) {
+                    ++stats.modified;
+                }
+            }
+        }
+    }
+    if (writtenRowMin <= writtenRowMax) {
+        markRowsDirty(writtenRowMin, writtenRowMax);
+    }
+    return stats;
+}
+
+#endif // HEIGHT_FIELD_STOCK_H
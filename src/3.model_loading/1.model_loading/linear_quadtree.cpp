@@ -0,0 +1,460 @@
+#include "linear_quadtree.h"
+#include "parallel_radix_sort.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace {
+    //  QuadtreeNode::optimize ֵһ£϶ҶӲʹMortonѯ
+    const uint32_t Z_RANGE_QUERY_THRESHOLD = 50;
+    // Mortonÿλ
+    const int MORTON_BITS = 16;
+    // bulkLoad ÿ߳һμMorton
+    const size_t BULK_LOAD_GRAIN_SIZE = 8192;
+
+    // ڵѯཻ
+    struct RectNodeTest {
+        glm::vec2 minXZ, maxXZ;
+        bool operator()(const glm::vec2& nodeMin, const glm::vec2& nodeMax) const {
+            return !(maxXZ.x < nodeMin.x || minXZ.x > nodeMax.x || maxXZ.y < nodeMin.y || minXZ.y > nodeMax.y);
+        }
+    };
+
+    // ڵѯԲཻԲĵα߽ľƽ뾶ƽ
+    struct CircleNodeTest {
+        glm::vec2 center;
+        float radiusSq;
+        bool operator()(const glm::vec2& nodeMin, const glm::vec2& nodeMax) const {
+            float closestX = (std::max)(nodeMin.x, (std::min)(center.x, nodeMax.x));
+            float closestZ = (std::max)(nodeMin.y, (std::min)(center.y, nodeMax.y));
+            float distanceX = center.x - closestX;
+            float distanceZ = center.y - closestZ;
+            return (distanceX * distanceX + distanceZ * distanceZ) <= radiusSq;
+        }
+    };
+
+    inline bool insideRect(const Vertex* vertex, const glm::vec2& minXZ, const glm::vec2& maxXZ) {
+        return vertex->Position.x >= minXZ.x && vertex->Position.x <= maxXZ.x &&
+               vertex->Position.z >= minXZ.y && vertex->Position.z <= maxXZ.y;
+    }
+
+    inline bool insideCircle(const Vertex* vertex, const glm::vec2& center, float radiusSq) {
+        float dx = vertex->Position.x - center.x;
+        float dz = vertex->Position.z - center.y;
+        return (dx * dx + dz * dz) <= radiusSq;
+    }
+}
+
+LinearQuadtree::LinearQuadtree(glm::vec2 minBounds, glm::vec2 maxBounds, int maxLvl, int maxVertsPerNode)
+    : maxLevels((std::min)((std::max)(maxLvl, 0), MAX_LEVELS)),
+      maxVerticesPerNode(maxVertsPerNode),
+      minBounds_(minBounds),
+      maxBounds_(maxBounds),
+      zOrderQuery_(false),
+      built_(false) {
+}
+
+void LinearQuadtree::insert(Vertex* vertex) {
+    const glm::vec3& p = vertex->Position;
+    if (p.x < minBounds_.x || p.x > maxBounds_.x || p.z < minBounds_.y || p.z > maxBounds_.y) {
+        return; //  Quadtree һ£Ըڵ㷶Χ֮Ķ
+    }
+    pending_.push_back(vertex);
+    built_ = false;
+}
+
+void LinearQuadtree::bulkLoad(const std::vector<Vertex*>& vertices, ThreadPool* pool) {
+    clear();
+    std::vector<std::pair<uint64_t, Vertex*>> entries(vertices.size());
+    std::vector<uint8_t> inside(vertices.size());
+    auto encode = [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3& p = vertices[i]->Position;
+            inside[i] = (p.x >= minBounds_.x && p.x <= maxBounds_.x && p.z >= minBounds_.y && p.z <= maxBounds_.y) ? 1 : 0;
+            entries[i] = { inside[i] ? MortonCode::getVertexMortonCode(vertices[i], minBounds_, maxBounds_) : 0, vertices[i] };
+        }
+    };
+    if (pool) {
+        pool->parallelFor(vertices.size(), BULK_LOAD_GRAIN_SIZE, encode);
+    } else {
+        encode(0, vertices.size(), 0);
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (inside[i]) {
+            entries[kept++] = entries[i];
+        }
+    }
+    entries.resize(kept);
+
+    ParallelRadixSort::sortByKey(entries, 2 * MORTON_BITS, pool);
+    buildFromSorted(entries);
+}
+
+void LinearQuadtree::optimize() {
+    build();
+    zOrderQuery_ = true;
+    buildSoaPoints();
+}
+
+void LinearQuadtree::bindMeshes(const std::vector<Mesh>& meshes) {
+    vertexIndexer_.bind(meshes);
+}
+
+void LinearQuadtree::resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const {
+    vertexIndexer_.resolve(globalIndex, meshIndex, vertexIndex);
+}
+
+void LinearQuadtree::clear() {
+    pending_.clear();
+    nodes_.clear();
+    codes_.clear();
+    vertices_.clear();
+    soaPoints_.clear();
+    built_ = false;
+}
+
+void LinearQuadtree::writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const {
+    build();
+    writer.write(static_cast<int32_t>(maxLevels));
+    writer.write(static_cast<int32_t>(maxVerticesPerNode));
+    writer.write(minBounds_);
+    writer.write(maxBounds_);
+    writer.write(static_cast<uint8_t>(zOrderQuery_ ? 1 : 0));
+    writer.writeVector(nodes_);
+    writer.writeVector(codes_);
+    std::vector<uint32_t> indices(vertices_.size());
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+        indexer.indexOf(vertices_[i], indices[i]);
+    }
+    writer.writeVector(indices);
+}
+
+bool LinearQuadtree::readCache(BlobReader& reader, std::vector<Mesh>& meshes) {
+    int32_t levels = 0, vertsPerNode = 0;
+    uint8_t zOrderQuery = 0;
+    std::vector<uint32_t> indices;
+    clear();
+    reader.read(levels);
+    reader.read(vertsPerNode);
+    reader.read(minBounds_);
+    reader.read(maxBounds_);
+    reader.read(zOrderQuery);
+    reader.readVector(nodes_);
+    reader.readVector(codes_);
+    reader.readVector(indices);
+    if (!reader.ok() || levels < 0 || levels > MAX_LEVELS ||
+        nodes_.size() != levelOffset(levels + 1) || codes_.size() != indices.size()) {
+        clear();
+        return false;
+    }
+    // ѯֱýڵ codes_ / vertices_𻵵Ļ治Խ
+    for (const Node& node : nodes_) {
+        if (uint64_t(node.begin) + node.count > codes_.size()) {
+            clear();
+            return false;
+        }
+    }
+
+    MeshVertexIndexer indexer;
+    indexer.bind(meshes);
+    vertices_.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        vertices_[i] = indexer.vertexAt(meshes, indices[i]);
+        if (!vertices_[i]) {
+            clear();
+            return false;
+        }
+    }
+    maxLevels = levels;
+    maxVerticesPerNode = vertsPerNode;
+    zOrderQuery_ = zOrderQuery != 0;
+    built_ = true; // SoA֮ optimize() й
+    return true;
+}
+
+void LinearQuadtree::build() const {
+    if (built_) {
+        return;
+    }
+
+    // 1. ϲѽĶ²Ķ㣬ڵ㷶ΧڵMorton
+    std::vector<std::pair<uint64_t, Vertex*>> entries;
+    entries.reserve(vertices_.size() + pending_.size());
+    for (Vertex* vertex : vertices_) {
+        entries.emplace_back(MortonCode::getVertexMortonCode(vertex, minBounds_, maxBounds_), vertex);
+    }
+    for (Vertex* vertex : pending_) {
+        entries.emplace_back(MortonCode::getVertexMortonCode(vertex, minBounds_, maxBounds_), vertex);
+    }
+    pending_.clear();
+
+    // 2. MortonȶͬһλõĶ㱣ֲ˳
+    ParallelRadixSort::sortByKey(entries, 2 * MORTON_BITS, nullptr);
+    buildFromSorted(entries);
+}
+
+void LinearQuadtree::buildFromSorted(const std::vector<std::pair<uint64_t, Vertex*>>& entries) const {
+    codes_.resize(entries.size());
+    vertices_.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        codes_[i] = entries[i].first;
+        vertices_[i] = entries[i].second;
+    }
+
+    // 3. ͳƣͬһǰ׺Ķһ
+    nodes_.assign(levelOffset(maxLevels + 1), Node{ 0, 0, 1, { 0, 0, 0 } });
+    for (int level = 0; level <= maxLevels; ++level) {
+        const int shift = 2 * (MORTON_BITS - level);
+        const size_t offset = levelOffset(level);
+        size_t i = 0;
+        while (i < codes_.size()) {
+            uint64_t prefix = codes_[i] >> shift;
+            size_t j = i + 1;
+            while (j < codes_.size() && (codes_[j] >> shift) == prefix) {
+                ++j;
+            }
+            Node& node = nodes_[offset + prefix];
+            node.begin = static_cast<uint32_t>(i);
+            node.count = static_cast<uint32_t>(j - i);
+            node.isLeaf = (level == maxLevels || node.count <= static_cast<uint32_t>(maxVerticesPerNode)) ? 1 : 0;
+            i = j;
+        }
+    }
+    built_ = true;
+
+    // ԭеSoAʧЧ
+    soaPoints_.clear();
+    if (zOrderQuery_) {
+        buildSoaPoints();
+    }
+}
+
+void LinearQuadtree::buildSoaPoints() const {
+    soaPoints_.clear();
+    if (!vertexIndexer_.isBound()) {
+        return;
+    }
+    // ֻ޸ĶY꣬�XZʼЧ
+    soaPoints_.reserve(vertices_.size());
+    for (Vertex* vertex : vertices_) {
+        uint32_t index = 0;
+        vertexIndexer_.indexOf(vertex, index);
+        soaPoints_.push_back(vertex->Position.x, vertex->Position.z, index);
+    }
+    soaPoints_.finalize();
+}
+
+void LinearQuadtree::nodeBounds(int level, uint64_t prefix, glm::vec2& nodeMin, glm::vec2& nodeMax) const {
+    glm::vec2 extent = maxBounds_ - minBounds_;
+    if (extent.x < 1e-6) extent.x = 1.0f; //  MortonCode::quantizePosition һ
+    if (extent.y < 1e-6) extent.y = 1.0f;
+
+    // ڵ㸲ǵ귶ΧΪ [cell, cell + side)ظΪر߽
+    const int cellBits = MORTON_BITS - level;
+    glm::uvec2 cell = MortonCode::decode(prefix << (2 * cellBits));
+    float side = static_cast<float>(1u << cellBits);
+    const float resolution = static_cast<float>(MortonCode::MORTON_RESOLUTION);
+    nodeMin = minBounds_ + extent * (glm::vec2(cell) / resolution);
+    nodeMax = minBounds_ + extent * ((glm::vec2(cell) + side) / resolution);
+}
+
+template <typename NodeTestFn, typename VisitSpanFn>
+void LinearQuadtree::collect(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                             NodeTestFn&& intersectsNode, VisitSpanFn&& visitSpan) const {
+    build();
+    if (nodes_.empty() || nodes_[0].count == 0) {
+        return;
+    }
+
+    // ѯΧжӦMortonΧֻһΣнϴҶӹ
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    bool rangesReady = false;
+
+    // ʽջݹ飬ջб (㼶, Mortonǰ׺)
+    std::pair<int, uint64_t> stack[3 * MAX_LEVELS + 4];
+    int top = 0;
+    stack[top++] = { 0, 0 };
+    while (top > 0) {
+        std::pair<int, uint64_t> current = stack[--top];
+        const Node& node = nodes_[levelOffset(current.first) + current.second];
+        if (node.count == 0) {
+            continue;
+        }
+        glm::vec2 nodeMin, nodeMax;
+        nodeBounds(current.first, current.second, nodeMin, nodeMax);
+        if (!intersectsNode(nodeMin, nodeMax)) {
+            continue;
+        }
+        if (!node.isLeaf) {
+            for (uint64_t child = 0; child < 4; ++child) {
+                stack[top++] = { current.first + 1, (current.second << 2) | child };
+            }
+            continue;
+        }
+
+        const uint32_t end = node.begin + node.count;
+        if (!zOrderQuery_ || node.count <= Z_RANGE_QUERY_THRESHOLD) {
+            // ٵҶֱɨ
+            visitSpan(size_t(node.begin), size_t(end));
+            continue;
+        }
+
+        // ϶ҶӣֻѯΧཻMorton
+        if (!rangesReady) {
+            glm::uvec2 qMin = MortonCode::quantizePosition({ minXZ.x, 0.0f, minXZ.y }, minBounds_, maxBounds_);
+            glm::uvec2 qMax = MortonCode::quantizePosition({ maxXZ.x, 0.0f, maxXZ.y }, minBounds_, maxBounds_);
+            MortonCode::getMortonRangesForRect(qMin, qMax, ranges);
+            rangesReady = true;
+        }
+        auto first = codes_.begin() + node.begin;
+        auto last = codes_.begin() + end;
+        for (const auto& range : ranges) {
+            if (range.second < *first) continue;
+            if (range.first > *(last - 1)) break;
+            first = std::lower_bound(first, last, range.first);
+            auto rangeEnd = std::upper_bound(first, last, range.second);
+            if (first != rangeEnd) {
+                visitSpan(size_t(first - codes_.begin()), size_t(rangeEnd - codes_.begin()));
+            }
+            first = rangeEnd;
+            if (first == last) break;
+        }
+    }
+}
+
+template <typename NodeTestFn, typename SoaFn, typename InsideFn>
+void LinearQuadtree::collectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                                    NodeTestFn&& intersectsNode, SoaFn&& testSoa, InsideFn&& inside,
+                                    std::vector<uint32_t>& resultIndices) const {
+    build();
+    if (soaPoints_.count > 0) {
+        collect(minXZ, maxXZ, intersectsNode, testSoa);
+        return;
+    }
+    // δSoAݣδδŻж϶Ϊ
+    collect(minXZ, maxXZ, intersectsNode, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t index;
+            if (inside(vertices_[i]) && vertexIndexer_.indexOf(vertices_[i], index)) {
+                resultIndices.push_back(index);
+            }
+        }
+    });
+}
+
+template <typename VisitFn>
+void LinearQuadtree::forEachInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const {
+    collect(minXZ, maxXZ, RectNodeTest{ minXZ, maxXZ }, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (insideRect(vertices_[i], minXZ, maxXZ)) {
+                visit(vertices_[i]);
+            }
+        }
+    });
+}
+
+template <typename VisitFn>
+void LinearQuadtree::forEachInRange(const glm::vec2& center, float radius, VisitFn&& visit) const {
+    const float radiusSq = radius * radius;
+    collect(center - glm::vec2(radius), center + glm::vec2(radius), CircleNodeTest{ center, radiusSq },
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (insideCircle(vertices_[i], center, radiusSq)) {
+                    visit(vertices_[i]);
+                }
+            }
+        });
+}
+
+std::vector<Vertex*> LinearQuadtree::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<Vertex*> resultVertices;
+    queryRect(minXZ, maxXZ, resultVertices);
+    return resultVertices;
+}
+
+std::vector<uint32_t> LinearQuadtree::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<uint32_t> resultIndices;
+    queryRectIndices(minXZ, maxXZ, resultIndices);
+    return resultIndices;
+}
+
+std::vector<Vertex*> LinearQuadtree::queryRange(const glm::vec2& center, float radius) const {
+    std::vector<Vertex*> resultVertices;
+    queryRange(center, radius, resultVertices);
+    return resultVertices;
+}
+
+std::vector<uint32_t> LinearQuadtree::queryRangeIndices(const glm::vec2& center, float radius) const {
+    std::vector<uint32_t> resultIndices;
+    queryRangeIndices(center, radius, resultIndices);
+    return resultIndices;
+}
+
+void LinearQuadtree::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const {
+    forEachInRect(minXZ, maxXZ, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void LinearQuadtree::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const {
+    collectIndices(minXZ, maxXZ, RectNodeTest{ minXZ, maxXZ },
+        [&](size_t begin, size_t end) {
+            SoaPointQuery::queryRect(soaPoints_, begin, end, minXZ, maxXZ, resultIndices);
+        },
+        [&](const Vertex* vertex) { return insideRect(vertex, minXZ, maxXZ); },
+        resultIndices);
+}
+
+void LinearQuadtree::queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const {
+    forEachInRange(center, radius, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void LinearQuadtree::queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const {
+    const float radiusSq = radius * radius;
+    collectIndices(center - glm::vec2(radius), center + glm::vec2(radius), CircleNodeTest{ center, radiusSq },
+        [&](size_t begin, size_t end) {
+            SoaPointQuery::queryCircle(soaPoints_, begin, end, center, radiusSq, resultIndices);
+        },
+        [&](const Vertex* vertex) { return insideCircle(vertex, center, radiusSq); },
+        resultIndices);
+}
+
+void LinearQuadtree::visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const {
+    forEachInRange(center, radius, visitor);
+}
+
+void LinearQuadtree::visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const {
+    forEachInRect(minXZ, maxXZ, visitor);
+}
+
+void LinearQuadtree::printTreeContents() const {
+    build();
+    std::cout << "\n--- Linear Quadtree Contents Start ---" << std::endl;
+    std::cout << "Vertices: " << vertices_.size() << ", Node slots: " << nodes_.size() << std::endl;
+    // ˳ӡʵʴڵĽڵ㣬ʽ QuadtreeNode::printVertices һ
+    std::vector<std::pair<int, uint64_t>> stack;
+    stack.push_back({ 0, 0 });
+    while (!stack.empty()) {
+        std::pair<int, uint64_t> current = stack.back();
+        stack.pop_back();
+        const Node& node = nodes_[levelOffset(current.first) + current.second];
+        glm::vec2 nodeMin, nodeMax;
+        nodeBounds(current.first, current.second, nodeMin, nodeMax);
+        std::string indent(current.first * 2, ' ');
+        std::cout << indent << "Node Level: " << current.first
+                  << ", Bounds: [(" << nodeMin.x << ", " << nodeMin.y << ") to ("
+                  << nodeMax.x << ", " << nodeMax.y << ")]"
+                  << ", Vertices: " << node.count
+                  << (node.isLeaf ? " (Leaf Node)" : " (Internal Node)") << std::endl;
+        if (!node.isLeaf) {
+            for (int child = 3; child >= 0; --child) {
+                uint64_t childPrefix = (current.second << 2) | uint64_t(child);
+                if (nodes_[levelOffset(current.first + 1) + childPrefix].count > 0) {
+                    stack.push_back({ current.first + 1, childPrefix });
+                }
+            }
+        }
+    }
+    std::cout << "--- Linear Quadtree Contents End ---\n" << std::endl;
+}
@@ -0,0 +1,116 @@
+#ifndef LINEAR_QUADTREE_H
+#define LINEAR_QUADTREE_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <learnopengl/mesh.h> // For Vertex struct
+#include "morton_code.h"
+#include "soa_point_query.h"
+#include "binary_blob.h"
+#include "vertex_visitor.h"
+
+class ThreadPool;
+
+// ԣʽĲΪڵ㵥ڴ棬Ҳûӽڵָ롣
+// ж㰴ڵ㷶ΧڵMortonһУ
+//  L 㡢Mortonǰ׺Ϊ p Ľڵڽڵе±Ϊ (4^L - 1) / 3 + p
+// ڵֻ¼䶥еʼλ
+// ӿ Quadtree һ£ֱ滻 MillingManager еĲжԱȡ
+class LinearQuadtree {
+public:
+    int maxLevels;
+    int maxVerticesPerNode; // Ҷӽڵڷǰɵ󶥵
+
+    // ΪƽڵС4^L Ϊ MAX_LEVELS
+    static constexpr int MAX_LEVELS = 10;
+
+    LinearQuadtree(glm::vec2 minBounds, glm::vec2 maxBounds, int maxLvl, int maxVertsPerNode);
+
+    // ֻѶһβѯ optimizeʱһ
+    void insert(Vertex* vertex);
+    //  vertices Morton벢м㣬ʹòлpool Ϊʱм
+    void bulkLoad(const std::vector<Vertex*>& vertices, ThreadPool* pool);
+    // ѯԲཻĶ (XZƽ)
+    std::vector<Vertex*> queryRange(const glm::vec2& center, float radius) const;
+    // ѯڸڵĶ (XZƽ)
+    std::vector<Vertex*> queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // ѯԶŷأ MeshVertexIndexerѹSoAʱ Vertex*
+    std::vector<uint32_t> queryRangeIndices(const glm::vec2& center, float radius) const;
+    std::vector<uint32_t> queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // Ĳѯͬѽ׷ӵߵĩβգʱѯٷڴ
+    void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const;
+    void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const;
+    void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const;
+    void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const;
+    // صʽҶɨжԷΧڵÿֱӵ visitorɽ
+    void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const;
+    void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const;
+
+    // ¼֮ optimize() ΪĶ鹹SoA
+    void bindMeshes(const std::vector<Mesh>& meshes);
+    // ѲѯصĶŻΪ±ڵĶ±
+    void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const;
+
+    // ö϶ҶʹMortonѯѰʱͬʱSoAݣ
+    void optimize();
+
+    void clear();
+
+    // 棨 StockCacheдMorton롢ڵͶţindexer ȫֱţ
+    // ȡʱֱӻָټMortonЧʱ false
+    void writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const;
+    bool readCache(BlobReader& reader, std::vector<Mesh>& meshes);
+
+    // ӡ (ڵ)
+    void printTreeContents() const;
+
+private:
+    struct Node {
+        uint32_t begin;  //  vertices_ / codes_ еʼ±
+        uint32_t count;  // ýڵ㷶ΧڵĶڵ㣩
+        uint8_t isLeaf;
+        uint8_t padding[3]; // ʽ䣺ڵ㰴ֽд뻺棬ЩֽȷֵʼΪ0
+    };
+
+    static size_t levelOffset(int level) { return ((size_t(1) << (2 * level)) - 1) / 3; }
+    //  level 㡢ǰ׺Ϊ prefix ĽڵXZƽϵģأ߽
+    void nodeBounds(int level, uint64_t prefix, glm::vec2& nodeMin, glm::vec2& nodeMax) const;
+    void build() const;
+    // ɰMorton (, ) ͳƽڵ
+    void buildFromSorted(const std::vector<std::pair<uint64_t, Vertex*>>& entries) const;
+    void buildSoaPoints() const;
+
+    // ѯཻҶӣ± [begin, end) Ϊλص visitSpan
+    // [minXZ, maxXZ] ΪѯİΧУڼϴҶӵMorton
+    template <typename NodeTestFn, typename VisitSpanFn>
+    void collect(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                 NodeTestFn&& intersectsNode, VisitSpanFn&& visitSpan) const;
+    // Բ / βѯԷΧڵÿ visit
+    template <typename VisitFn>
+    void forEachInRange(const glm::vec2& center, float radius, VisitFn&& visit) const;
+    template <typename VisitFn>
+    void forEachInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const;
+    // ŲѯSoAʱ testSoa inside
+    template <typename NodeTestFn, typename SoaFn, typename InsideFn>
+    void collectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                        NodeTestFn&& intersectsNode, SoaFn&& testSoa, InsideFn&& inside,
+                        std::vector<uint32_t>& resultIndices) const;
+
+    glm::vec2 minBounds_;
+    glm::vec2 maxBounds_;
+    bool zOrderQuery_;
+
+    // ѯʱ轨³ԱΪ mutable
+    mutable std::vector<Vertex*> pending_;   // δĶ
+    mutable std::vector<Node> nodes_;        // вĽڵ㣬㡢Mortonǰ׺
+    mutable std::vector<uint64_t> codes_;    // Morton
+    mutable std::vector<Vertex*> vertices_;  //  codes_ һһӦĶ
+    mutable SoaPoints soaPoints_;            //  codes_ һһӦSoAݣoptimize() Ѱʱ
+    MeshVertexIndexer vertexIndexer_;
+    mutable bool built_;
+};
+
+#endif // LINEAR_QUADTREE_H
@@ -1,10 +1,84 @@
 #include "Application.h"
+#include "mill_config.h"
 
-int main()
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// ÷
+//                                     Ĵģʽ
+//    --headless [--dt ] [--steps N]  ޴ģʽԹ̶·ӡʱ
+//                                          ָ --dt ʱ SIMULATION_STEP_MM 㲽
+//   ģʽԼ --toolpath ļ [--toolpath-scale λÿ]ʹG·
+//   ޴ģʽԼ --trace ļйд Chrome trace_event JSON
+//   ޴ģʽԼ --baseline ļ [--update-baseline] [--tolerance ]
+//   뱣ĻطŻ߱Ƚͺʱ߲ʱд룩һʱطֵ
+//   ģʽԼ --config ļȡռĲãʽ MillConfig
+//   ģʽԼ --spatial-index [,...]|allѡʹõĿռ spatialIndexNames()
+//   ļе spatial_index޴ģʽгʱλطŲԱȣģʽֻʹõһ
+int main(int argc, char** argv)
 {
+    bool headless = false;
+    float timeStep = 0.0f;
+    int maxSteps = 0;
+    const char* toolpathFile = nullptr;
+    float toolpathScale = 0.01f;
+    const char* traceFile = nullptr;
+    const char* baselineFile = nullptr;
+    bool updateBaseline = false;
+    double baselineTolerance = 0.1;
+    const char* configFile = nullptr;
+    const char* spatialIndex = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc)
+            timeStep = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+            maxSteps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--toolpath") == 0 && i + 1 < argc)
+            toolpathFile = argv[++i];
+        else if (std::strcmp(argv[i], "--toolpath-scale") == 0 && i + 1 < argc)
+            toolpathScale = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            traceFile = argv[++i];
+        else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            baselineFile = argv[++i];
+        else if (std::strcmp(argv[i], "--update-baseline") == 0)
+            updateBaseline = true;
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            baselineTolerance = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (std::strcmp(argv[i], "--spatial-index") == 0 && i + 1 < argc)
+            spatialIndex = argv[++i];
+    }
+
+    MillConfig config;
+    std::string error;
+    if (configFile && !config.load(configFile, error))
+    {
+        std::cerr << "Invalid config: " << error << std::endl;
+        return 1;
+    }
+    if (spatialIndex && !MillConfig::parseSpatialIndexList(spatialIndex, config.spatialIndexes, error))
+    {
+        std::cerr << "Invalid --spatial-index: " << error << std::endl;
+        return 1;
+    }
+
     Application app("LearnOpenGL_ModelLoading_Refactored");
+    app.setConfig(config);
+    if (toolpathFile)
+        app.setToolpathFile(toolpathFile, toolpathScale);
+    if (traceFile)
+        app.setTraceFile(traceFile);
+    if (baselineFile)
+        app.setReplayBaseline(baselineFile, updateBaseline, baselineTolerance);
+    if (headless)
+        return app.runHeadless(timeStep, maxSteps);
     app.run();
 
     return 0;
 }
-
@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+#ifdef _WIN32
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+#else
+    if (fd_ >= 0) close(fd_);
+#endif
+}
+
+bool MappedFile::open(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) return false;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ == 0) return true; // ļܴӳ
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    return mapping_ != nullptr;
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+    struct stat fileStat;
+    if (fstat(fd_, &fileStat) != 0) return false;
+    size_ = static_cast<size_t>(fileStat.st_size);
+    return true;
+#endif
+}
+
+const char* MappedFile::map(size_t offset, size_t length) {
+    unmap();
+#ifdef _WIN32
+    unsigned long long offset64 = offset;
+    view_ = MapViewOfFile(mapping_, FILE_MAP_READ, static_cast<DWORD>(offset64 >> 32),
+                          static_cast<DWORD>(offset64 & 0xFFFFFFFFull), length);
+    return static_cast<const char*>(view_);
+#else
+    void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(offset));
+    if (view == MAP_FAILED) return nullptr;
+    madvise(view, length, MADV_SEQUENTIAL);
+    view_ = view;
+    viewLength_ = length;
+    return static_cast<const char*>(view_);
+#endif
+}
+
+void MappedFile::unmap() {
+    if (!view_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(view_);
+#else
+    munmap(view_, viewLength_);
+#endif
+    view_ = nullptr;
+}
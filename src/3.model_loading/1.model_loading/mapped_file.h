@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// ֻļڴӳ䣬ͬһʱֻӳһ䣨ļҲ԰ӳ䣩
+// Gȡ̶СĿ˳ӳ䣬STL ȡһӳļ
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    size_t size() const { return size_; }
+
+    // ӳ [offset, offset + length)֮ǰӳᱻ
+    // offset ӳȣWindows Ϊ 64KBʧʱ nullptr
+    const char* map(size_t offset, size_t length);
+    void unmap();
+
+private:
+    size_t size_ = 0;
+    void* view_ = nullptr;
+#ifdef _WIN32
+    void* file_ = nullptr;    // HANDLE
+    void* mapping_ = nullptr; // HANDLE
+#else
+    int fd_ = -1;
+    size_t viewLength_ = 0;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,104 @@
+#include "mill_config.h"
+#include "spatial_index.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::string trim(const std::string& text) {
+        const char* whitespace = " \t\r";
+        size_t begin = text.find_first_not_of(whitespace);
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = text.find_last_not_of(whitespace);
+        return text.substr(begin, end - begin + 1);
+    }
+
+    template <typename T>
+    bool parseValue(const std::string& text, T& value) {
+        std::istringstream stream(text);
+        T parsed;
+        if (!(stream >> parsed) || !(stream >> std::ws).eof()) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+}
+
+bool MillConfig::parseSpatialIndexList(const std::string& list, std::vector<std::string>& names, std::string& error) {
+    std::vector<std::string> parsed;
+    std::istringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        name = trim(name);
+        if (name.empty()) {
+            continue;
+        }
+        if (name == "all") {
+            parsed.insert(parsed.end(), spatialIndexNames().begin(), spatialIndexNames().end());
+        } else if (isSpatialIndexName(name)) {
+            parsed.push_back(name);
+        } else {
+            error = "unknown spatial index '" + name + "' (expected all";
+            for (const std::string& known : spatialIndexNames()) {
+                error += ", " + known;
+            }
+            error += ")";
+            return false;
+        }
+    }
+    if (parsed.empty()) {
+        error = "empty spatial index list";
+        return false;
+    }
+    names = parsed;
+    return true;
+}
+
+bool MillConfig::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected key=value";
+            return false;
+        }
+        std::string key = trim(line.substr(0, separator));
+        std::string value = trim(line.substr(separator + 1));
+        bool valid;
+        if (key == "spatial_index") valid = parseSpatialIndexList(value, spatialIndexes, error);
+        else if (key == "surface_y") valid = parseValue(value, surfaceYValue);
+        else if (key == "surface_y_threshold") valid = parseValue(value, surfaceYThreshold);
+        else if (key == "quadtree_max_levels") valid = parseValue(value, quadtreeMaxLevels);
+        else if (key == "quadtree_max_verts_per_node") valid = parseValue(value, quadtreeMaxVertsPerNode);
+        else if (key == "height_field_resolution") valid = parseValue(value, heightFieldResolution);
+        else if (key == "tool") valid = hasToolType = parseToolType(value, toolShape.type);
+        else if (key == "tool_corner_radius") valid = parseValue(value, toolShape.cornerRadius);
+        else if (key == "tool_tip_radius") valid = parseValue(value, toolShape.tipRadius);
+        else if (key == "tool_taper_angle") valid = parseValue(value, toolShape.taperAngleDegrees);
+        else if (key == "tool_point_angle") valid = parseValue(value, toolShape.pointAngleDegrees);
+        else {
+            error = path + ":" + std::to_string(lineNumber) + ": unknown key '" + key + "'";
+            return false;
+        }
+        if (!valid) {
+            error = path + ":" + std::to_string(lineNumber) + ": invalid value for " + key +
+                    (error.empty() ? std::string() : " (" + error + ")");
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef MILL_CONFIG_H
+#define MILL_CONFIG_H
+
+#include <string>
+#include <vector>
+#include "tool_profile.h"
+
+// ãԴıļȡÿ key=value# ͷΪעͣвļеֵ
+// 磺
+//   spatial_index=quadtree-z,grid,scan
+//   quadtree_max_levels=6
+//   tool=bull-nose
+//   tool_corner_radius=0.003
+// spatial_index гռ all ʾȫ޴ģʽÿطͬһ·Աȣ
+// ģʽֻʹõһ
+struct MillConfig {
+    std::vector<std::string> spatialIndexes; // Ϊʱʹ MillingManager Ĭֵ Method.h
+    float surfaceYValue = 0.0f;              // ʶ涥Yοֵ
+    float surfaceYThreshold = 0.01f;         // Y surfaceYValue ֵ
+    int quadtreeMaxLevels = 3;
+    int quadtreeMaxVertsPerNode = 20;
+    int heightFieldResolution = 512;
+    // ״ ToolShapeΪ tooltool_corner_radiustool_tip_radiustool_taper_angletool_point_angle
+    // û tool ʱȡ Method.h е Type״ȻЧ
+    bool hasToolType = false;
+    ToolShape toolShape;
+
+    // ȡļļ޷򿪻޷ʶļֵʱ false  error ˵
+    bool load(const std::string& path, std::string& error);
+    // ŷָĿռб spatialIndexNames()all ʾȫδ֪ʱ false
+    static bool parseSpatialIndexList(const std::string& list, std::vector<std::string>& names, std::string& error);
+};
+
+#endif // MILL_CONFIG_H
@@ -1,11 +1,40 @@
 #include "milling_manager.h"
-#include "quadtree.h" // Quadtree 
+#include "spatial_index.h"
+#include "height_field_stock.h"
 #include <glm/gtc/matrix_transform.hpp> 
 #include <iostream>
 #include <vector>
 #include <limits> // For std::numeric_limits
 #include <cmath>  // For std::abs and std::sqrt
 #include "Method.h"
+#include "thread_pool.h"
+#include "frame_profiler.h"
+
+namespace {
+    // Method.h еĿضӦĿռƣ spatialIndexNames()
+    std::string defaultSpatialIndexName() {
+        if (!ENABLE_QUADTREE_OPTIMIZATION) {
+            return "none";
+        }
+        if (ENABLE_LINEAR_QUADTREE) {
+            return (ENABLE_Z_ORDER_OPTIMIZATION || ENABLE_SOA_LEAF_QUERY) ? "linear-z" : "linear";
+        }
+        if (!(ENABLE_Z_ORDER_OPTIMIZATION || ENABLE_SOA_LEAF_QUERY)) {
+            return "quadtree";
+        }
+        if (ENABLE_Z_ORDER_RANGE_QUERY) {
+            return "quadtree-z";
+        }
+        return ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING ? "quadtree-z-pruned" : "quadtree-z-scan";
+    }
+
+    // ѡڸʱֱӴ⻽̵߳Ŀ
+    const size_t PARALLEL_MILLING_MIN_CANDIDATES = 4096;
+    // ÿ߳һȡĺѡ
+    const size_t PARALLEL_MILLING_GRAIN_SIZE = 1024;
+    // ѯĳʼʱ std::vector ݣ֮Ĳѯ
+    const size_t CANDIDATE_BUFFER_RESERVE = 4096;
+}
 
 // ʼ̬Ա
 long long int MillingManager::numVertices = 0;
@@ -15,13 +44,35 @@ MillingManager::MillingManager(float toolRadius, float toolTipLocalYOffset, floa
     : toolRadius_(toolRadius),
       toolTipLocalYOffset_(toolTipLocalYOffset),
       cubeMinLocalY_(cubeMinLocalY),
-      toolheadType_(toolType),
-      quadtree_(nullptr) {
+      toolShape_(),
+      cutter_(),
+      lastToolTipLocal_(0.0f),
+      hasLastToolTip_(false),
+      spatialIndexName_(defaultSpatialIndexName()),
+      heightField_(nullptr) {
+    toolShape_.type = toolType;
+    cutter_ = CutterProfile(toolShape_, toolRadius_);
     numVertices = 0;
+#if ENABLE_PARALLEL_MILLING
+    threadPool_ = std::make_unique<ThreadPool>(PARALLEL_MILLING_THREADS);
+#endif
 }
 
 MillingManager::~MillingManager() {
-    // std::unique_ptr will automatically handle deletion of the Quadtree object
+    // std::unique_ptr will automatically handle deletion of the spatial index
+}
+
+void MillingManager::setToolShape(const ToolShape& shape) {
+    toolShape_ = shape;
+    cutter_ = CutterProfile(toolShape_, toolRadius_);
+}
+
+bool MillingManager::setSpatialIndex(const std::string& name) {
+    if (!isSpatialIndexName(name)) {
+        return false;
+    }
+    spatialIndexName_ = name;
+    return true;
 }
 
 void MillingManager::initializeSpatialPartition(Model& cubeModel, 
@@ -29,7 +80,11 @@ void MillingManager::initializeSpatialPartition(Model& cubeModel,
                                                 float surfaceYThreshold, 
                                                 int quadtreeMaxLevels, 
                                                 int quadtreeMaxVertsPerNode) {
-    quadtree_.reset(); // Clear any existing quadtree
+    spatialIndex_.reset(); // Clear any existing spatial index
+    heightField_.reset();
+    if (spatialIndexName_ == "none") {
+        return;
+    }
 
     // ռڱĶָ뼯ϣȻë XZ ֲ귶Χ
     std::vector<Vertex*> surfaceVertices;
@@ -51,7 +106,7 @@ void MillingManager::initializeSpatialPartition(Model& cubeModel,
     }
 
     if (!foundSurfaceVertices || surfaceVertices.empty()) {
-        std::cout << "MillingManager: No surface vertices found to build Quadtree." << std::endl;
+        std::cout << "MillingManager: No surface vertices found to build spatial index." << std::endl;
         return;
     }
     // һëģ͵Ч2d߽
@@ -59,41 +114,102 @@ void MillingManager::initializeSpatialPartition(Model& cubeModel,
     if (minXZ.x >= maxXZ.x || minXZ.y >= maxXZ.y) {
          // Handle degenerate case, e.g. all points on a line or single point.
          // For simplicity, create a small default area around the points or log an error.
-         std::cout << "MillingManager: Degenerate bounds for Quadtree. Expanding slightly." << std::endl;
+         std::cout << "MillingManager: Degenerate bounds for spatial index. Expanding slightly." << std::endl;
          // Provide a small default size if bounds are too small, e.g., if maxXZ is not greater than minXZ.
          // This can happen if all surface vertices are collinear or coincident.
          if (minXZ.x >= maxXZ.x) maxXZ.x = minXZ.x + 0.1f; // Add a small epsilon
          if (minXZ.y >= maxXZ.y) maxXZ.y = minXZ.y + 0.1f; // Add a small epsilon
     }
 
-    // һĲĸڵ㣬ڵëģxzƽڵķΧһοëģǷǾΣ
-    quadtree_ = std::make_unique<Quadtree>(minXZ, maxXZ, quadtreeMaxLevels, quadtreeMaxVertsPerNode);
-    std::cout << "MillingManager: Building Quadtree with bounds: (" 
+    // ռΧëģxzƽڵķΧһοëģǷǾΣ
+    // ĵԪ߳ȡ߰뾶һε 3x3 Ԫ
+    SpatialIndexParams params;
+    params.quadtreeMaxLevels = quadtreeMaxLevels;
+    params.quadtreeMaxVertsPerNode = quadtreeMaxVertsPerNode;
+    params.gridCellSize = toolRadius_;
+    spatialIndex_ = createSpatialIndex(spatialIndexName_, params);
+    std::cout << "MillingManager: Building " << spatialIndexName_ << " spatial index with bounds: ("
               << minXZ.x << ", " << minXZ.y << ") to (" 
               << maxXZ.x << ", " << maxXZ.y << ") for " 
               << surfaceVertices.size() << " vertices." << std::endl;
 
-    // ڵĲУڵָ룬涥ָ䵽Ĳ
-    for (Vertex* vertex : surfaceVertices) {
-        quadtree_->insert(vertex);
-    }
-    std::cout << "MillingManager: Quadtree built." << std::endl;
-#if ENABLE_Z_ORDER_OPTIMIZATION
-    // ---- ZŻ ----
-    std::cout << "MillingManager: Optimizing Quadtree leaves with Z-order curve..." << std::endl;
-    quadtree_->optimize();
-    std::cout << "MillingManager: Quadtree optimization finished." << std::endl;
-    // ---- ZŻ ----
-#endif
+    // ѱ涥ָ䵽ռУû̳߳ʱִУ
+    spatialIndex_->build(cubeModel.meshes, surfaceVertices, minXZ, maxXZ, threadPool_.get());
+    reserveCandidateBuffers();
+    std::cout << "MillingManager: Spatial index built." << std::endl;
 #if ENABLE_QUADTREE_DEBUG_PRINT
-    // ӡĲԹ
-    if (quadtree_) {
-        std::cout << "MillingManager: Attempting to print Quadtree contents..." << std::endl;
-        quadtree_->printTreeContents();
-    } else {
-        std::cout << "MillingManager: Quadtree is null, cannot print contents." << std::endl;
+    // ӡռԹ
+    std::cout << "MillingManager: Attempting to print spatial index contents..." << std::endl;
+    spatialIndex_->printContents();
+#endif
+}
+
+bool MillingManager::serializeSpatialPartition(const Model& cubeModel, std::vector<char>& out) const {
+    if (!spatialIndex_) {
+        return false;
+    }
+    MeshVertexIndexer indexer;
+    indexer.bind(cubeModel.meshes);
+    BlobWriter writer(out);
+    return spatialIndex_->writeCache(writer, indexer);
+}
+
+bool MillingManager::restoreSpatialPartition(Model& cubeModel, const char* data, size_t size) {
+    spatialIndex_.reset();
+    heightField_.reset();
+
+    SpatialIndexParams params;
+    params.gridCellSize = toolRadius_;
+    std::unique_ptr<ISpatialIndex> index = createSpatialIndex(spatialIndexName_, params);
+    if (!index) {
+        return false;
+    }
+    BlobReader reader(data, size);
+    if (!index->readCache(reader, cubeModel.meshes)) {
+        std::cout << "MillingManager: Cached " << spatialIndexName_ << " spatial index is invalid, rebuilding." << std::endl;
+        return false;
     }
+    spatialIndex_ = std::move(index);
+    reserveCandidateBuffers();
+    std::cout << "MillingManager: " << spatialIndexName_ << " spatial index restored from cache." << std::endl;
+#if ENABLE_QUADTREE_DEBUG_PRINT
+    spatialIndex_->printContents();
 #endif
+    return true;
+}
+
+void MillingManager::initializeHeightField(Model& cubeModel,
+                                           float surfaceYValue,
+                                           int resolutionX,
+                                           int resolutionZ) {
+    // ߶ȳȡԭʼ󣬿ռбĶָʧЧ
+    spatialIndex_.reset();
+    heightField_.reset();
+
+    glm::vec2 minXZ(std::numeric_limits<float>::max());
+    glm::vec2 maxXZ(std::numeric_limits<float>::lowest());
+    for (const Mesh& mesh : cubeModel.meshes) {
+        for (const Vertex& vertex : mesh.vertices) {
+            minXZ.x = std::min(minXZ.x, vertex.Position.x);
+            minXZ.y = std::min(minXZ.y, vertex.Position.z);
+            maxXZ.x = std::max(maxXZ.x, vertex.Position.x);
+            maxXZ.y = std::max(maxXZ.y, vertex.Position.z);
+        }
+    }
+    if (minXZ.x >= maxXZ.x || minXZ.y >= maxXZ.y) {
+        std::cout << "MillingManager: Degenerate stock bounds, height field not created." << std::endl;
+        return;
+    }
+
+    heightField_ = std::make_unique<HeightFieldStock>(minXZ, maxXZ, resolutionX, resolutionZ, surfaceYValue, cubeMinLocalY_);
+    std::cout << "MillingManager: Building height field " << heightField_->getResolutionX() << " x "
+              << heightField_->getResolutionZ() << " over (" << minXZ.x << ", " << minXZ.y << ") to ("
+              << maxXZ.x << ", " << maxXZ.y << ")." << std::endl;
+
+    // ø߶ȳɵ滻ԭʼSTL֮ĻƶʹøԴ涥ʽԭ񱣳һ
+    VertexLayout layout = cubeModel.meshes.empty() ? VertexLayout::Full : cubeModel.meshes[0].getVertexLayout();
+    cubeModel.meshes.clear();
+    cubeModel.meshes.push_back(heightField_->buildMesh(layout));
 }
 
 long long int MillingManager::getNumVertices()
@@ -104,10 +220,13 @@ long long int MillingManager::getNumVertices()
 bool MillingManager::processMilling(Model& cubeModel,
                                     const glm::vec3& cubeWorldPosition,
                                     const glm::vec3& toolBaseWorldPosition,
-                                    bool isMillingEnabled) {
+                                    bool isMillingEnabled,
+                                    const std::vector<glm::vec3>* passedCubePositions) {
     if (!isMillingEnabled) {
+        hasLastToolTip_ = false; // ϳرڼƶӦһɨ
         return false;
     }
+    FrameProfiler::Scope millingSpan("processMilling");
 
     glm::mat4 model_cube_matrix = glm::translate(glm::mat4(1.0f), cubeWorldPosition);
     glm::mat4 world_to_cube_local_matrix = glm::inverse(model_cube_matrix);
@@ -120,119 +239,409 @@ bool MillingManager::processMilling(Model& cubeModel,
 
     bool vertices_modified = false;
 
-    if (quadtree_) {
+    glm::vec3 sweep_start_local = tool_tip_cube_local;
+#if ENABLE_SWEPT_MILLING
+    // һ֡ĵλΪ㣬гƶɨĲϣ󲽳ʱ
+    const bool has_sweep_start = hasLastToolTip_;
+    if (has_sweep_start) {
+        sweep_start_local = lastToolTipLocal_;
+    }
+#endif
+    lastToolTipLocal_ = tool_tip_cube_local;
+    hasLastToolTip_ = true;
+
+    // ѡһ״ԣѭÿֵ߷ֱʵ
+    auto sweepSegment = [&](const glm::vec3& start_local, const glm::vec3& end_local) {
+        return dispatchToolProfile(toolShape_.type, cutter_, [&](const auto& profile) {
+            if (heightField_) {
+                return processHeightFieldMilling(profile, start_local, end_local);
+            }
+            return processSweptMilling(cubeModel, profile, start_local, end_local);
+        });
+    };
+#if ENABLE_SWEPT_MILLING
+    // ;ĺ㣺ëֻƽƣëֲϵеλü  - ëλ
+    if (has_sweep_start && passedCubePositions) {
+        for (const glm::vec3& cube_position : *passedCubePositions) {
+            glm::vec3 corner_local = tool_tip_effective_world_position - cube_position;
+            if (corner_local != sweep_start_local && corner_local != tool_tip_cube_local) {
+                vertices_modified |= sweepSegment(sweep_start_local, corner_local);
+                sweep_start_local = corner_local;
+            }
+        }
+    }
+#else
+    (void)passedCubePositions;
+#endif
+
+    if (heightField_) {
+        // ߶ȳëٰддػõ
+        // ߶ȱ仯ֵʱ vertices_modified Ϊ falseЩҲѱǣͬҪϴ
+        vertices_modified |= sweepSegment(sweep_start_local, tool_tip_cube_local);
+        if (!cubeModel.meshes.empty()) {
+            heightField_->updateMesh(cubeModel.meshes[0]);
+        }
+    }
+#if ENABLE_SWEPT_MILLING
+    else {
+        vertices_modified |= sweepSegment(sweep_start_local, tool_tip_cube_local);
+    }
+#else
+    else {
+        vertices_modified = dispatchToolProfile(toolShape_.type, cutter_, [&](const auto& profile) {
+            return processPointMilling(cubeModel, profile, tool_tip_cube_local);
+        });
+    }
+#endif
+
+    FrameProfiler::traceCounter("numVertices", numVertices);
+    FrameProfiler::traceCounter("numModifiedVertices", numModifiedVertices);
+
+    if (deferredUpload_) {
+        return vertices_modified; // ҳ
+    }
+    FrameProfiler::Scope uploadScope(FrameProfiler::VboUpload);
+#if ENABLE_DIRTY_RANGE_UPLOAD
+    // ֻϴǵĶҳûбдֱOpenGL
+    // ߶ȱ仯ԺԵдͬᱻϴԴеʼ vertices һ
+    for (unsigned int i = 0; i < cubeModel.meshes.size(); ++i) {
+        FrameProfiler::Scope meshUploadSpan("Mesh::uploadDirtyVertices");
+        cubeModel.meshes[i].uploadDirtyVertices();
+    }
+#else
+    if (vertices_modified) {
+        for (unsigned int i = 0; i < cubeModel.meshes.size(); ++i) {
+            cubeModel.meshes[i].updateVertexBuffer();
+        }
+    }
+#endif
+    return vertices_modified;
+}
+
+template <typename Profile>
+bool MillingManager::processPointMilling(Model& cubeModel, const Profile& profile, const glm::vec3& toolTipLocal) {
+    bool vertices_modified = false;
+    if (spatialIndex_) {
         //std::cout << "use quadTree!" << std::endl;
         // Optimized path using Quadtree
-        std::vector<Vertex*> candidateVertices = quadtree_->queryRange(glm::vec2(tool_tip_cube_local.x, tool_tip_cube_local.z), toolRadius_);
-        //std::cout << "Queried vertices: " << candidateVertices.size() << std::endl;
-
-        numVertices += candidateVertices.size();
-        for (Vertex* current_vertex_ptr : candidateVertices) {
-            Vertex& current_vertex = *current_vertex_ptr; // Dereference pointer
-            
-            // XZ distance check might be redundant if queryRange is accurate enough, but it's safer.
-            // The queryRange in QuadtreeNode already does a precise circle check for leaf nodes.
-            // BUG FIX: The check below is NOT redundant. The query returns all vertices in intersecting
-            // nodes, not just vertices within the circle. This check is CRITICAL.
-            float dx = current_vertex.Position.x - tool_tip_cube_local.x;
-            float dz = current_vertex.Position.z - tool_tip_cube_local.z;
-            float dist_xz_squared = dx * dx + dz * dz;
-            if (dist_xz_squared < (toolRadius_ * toolRadius_)) { 
-
-                float target_y_cut = glm::max(tool_tip_cube_local.y, cubeMinLocalY_);
-                if (current_vertex.Position.y > target_y_cut) {
-                    float old_y = current_vertex.Position.y;
-                    switch (toolheadType_) {
-                        case ToolType::flat:
-                            current_vertex.Position.y = target_y_cut;
-                            current_vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f); // Set color to red
-                            // ƽֱָϷ (Y)
-                            current_vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
-                            break;
-                        case ToolType::ball: {
-                            // For ball nose, the effective cutting Y depends on XZ distance from tool center
-                            float dx_ball = current_vertex.Position.x - tool_tip_cube_local.x;
-                            float dz_ball = current_vertex.Position.z - tool_tip_cube_local.z;
-                            float dist_xz_squared_ball = dx_ball * dx_ball + dz_ball * dz_ball;
-                            float radius_squared = toolRadius_ * toolRadius_;
-                            if (dist_xz_squared_ball < radius_squared) { // Ensure it's within the tool's footprint for ball calculation
-                                float y_offset_ball = std::sqrt(radius_squared - dist_xz_squared_ball);
-                                float ball_surface_y = tool_tip_cube_local.y + toolRadius_ - y_offset_ball; // Lowest point of tool is tool_tip_cube_local.y
-                                float actual_cut_y = glm::max(ball_surface_y, cubeMinLocalY_);                             
-                                if (current_vertex.Position.y > actual_cut_y) {
-                                    current_vertex.Position.y = actual_cut_y;
-                                    current_vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f); // Set color to red
-                                    // Ǵָ򶥵λ
-                                    glm::vec3 sphere_center_local = tool_tip_cube_local + glm::vec3(0.0f, toolRadius_, 0.0f);
-                                    current_vertex.Normal = glm::normalize(current_vertex.Position - sphere_center_local);
-                                }
-                            } // else: vertex is outside the direct spherical cut, no change from ball specific part
-                            break;
-                        }
-                        default:
-                            break;
-                    }
-                    if (std::abs(current_vertex.Position.y - old_y) > 0.00001f) { // Check if Y actually changed
-                         vertices_modified = true;
-                         numModifiedVertices++;
-                    }
-                }
+        const glm::vec2 tool_center_xz(toolTipLocal.x, toolTipLocal.z);
+#if ENABLE_SOA_LEAF_QUERY
+        {
+            FrameProfiler::Scope queryScope(FrameProfiler::QuadtreeQuery);
+            candidateIndices_.clear();
+            spatialIndex_->queryRangeIndices(tool_center_xz, toolRadius_, candidateIndices_);
+        }
+        numVertices += candidateIndices_.size();
+        FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+        for (uint32_t candidate : candidateIndices_) {
+            uint32_t mesh_index, vertex_index;
+            spatialIndex_->resolveIndex(candidate, mesh_index, vertex_index);
+            VertexCutResult result = cutVertexPoint(profile, cubeModel.meshes[mesh_index].vertices[vertex_index], toolTipLocal);
+            if (result != VertexCutResult::Untouched) {
+                cubeModel.meshes[mesh_index].markVertexDirty(vertex_index);
+            }
+            if (result == VertexCutResult::Modified) {
+                vertices_modified = true;
+                numModifiedVertices++;
             }
         }
-
+#else
+        // Ҷɨֱɺѡ顣ѯʱ CutKernel FrameProfiler::Phase
+        FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+        spatialIndex_->visitRange(tool_center_xz, toolRadius_, [&](Vertex* current_vertex_ptr) {
+            numVertices++;
+            VertexCutResult result = cutVertexPoint(profile, *current_vertex_ptr, toolTipLocal);
+            if (result != VertexCutResult::Untouched) {
+                markVertexDirty(cubeModel, current_vertex_ptr);
+            }
+            if (result == VertexCutResult::Modified) {
+                vertices_modified = true;
+                numModifiedVertices++;
+            }
+        });
+#endif
     } else {
         // Fallback to old behavior if Quadtree is not initialized (or keep this as an error/warning)
         //std::cerr << "MillingManager: Quadtree not initialized. Falling back to unoptimized milling." << std::endl;
-        for (unsigned int i = 0; i < cubeModel.meshes.size(); ++i) {
-            Mesh& current_mesh = cubeModel.meshes[i];
-            for (unsigned int j = 0; j < current_mesh.vertices.size(); ++j) {
-                Vertex& current_vertex = current_mesh.vertices[j];
-                float dx = current_vertex.Position.x - tool_tip_cube_local.x;
-                float dz = current_vertex.Position.z - tool_tip_cube_local.z;
-                float dist_xz_squared = dx * dx + dz * dz;
-
-                if (dist_xz_squared < (toolRadius_ * toolRadius_)) {
-                    float target_y_cut = glm::max(tool_tip_cube_local.y, cubeMinLocalY_);
-                    if (current_vertex.Position.y > target_y_cut) {
-                         float old_y = current_vertex.Position.y;
-                        switch (toolheadType_) {
-                            case ToolType::flat:
-                                current_vertex.Position.y = target_y_cut;
-                                current_vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f); // Set color to red
-                                // ƽֱָϷ (Y)
-                                current_vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
-                                break;
-                            case ToolType::ball: {
-                                float radius_squared = toolRadius_ * toolRadius_;
-                                float y_offset_ball = std::sqrt(radius_squared - dist_xz_squared); // dist_xz_squared is already calculated
-                                float ball_surface_y = tool_tip_cube_local.y + toolRadius_ - y_offset_ball;
-                                float actual_cut_y = glm::max(ball_surface_y, cubeMinLocalY_);
-                                 if (current_vertex.Position.y > actual_cut_y) {
-                                    current_vertex.Position.y = actual_cut_y;
-                                    current_vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f); // Set color to red
-                                    // Ǵָ򶥵λ
-                                    glm::vec3 sphere_center_local = tool_tip_cube_local + glm::vec3(0.0f, toolRadius_, 0.0f);
-                                    current_vertex.Normal = glm::normalize(current_vertex.Position - sphere_center_local);
-                                }
-                                break;
-                            }
-                            default:
-                                break;
-                        }
-                        if (std::abs(current_vertex.Position.y - old_y) > 0.00001f) {
-                            vertices_modified = true;
-                            numModifiedVertices++;
-                        }
-                    }
+        FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+        for (Mesh& current_mesh : cubeModel.meshes) {
+            for (size_t j = 0; j < current_mesh.vertices.size(); ++j) {
+                VertexCutResult result = cutVertexPoint(profile, current_mesh.vertices[j], toolTipLocal);
+                if (result != VertexCutResult::Untouched) {
+                    current_mesh.markVertexDirty(j);
+                }
+                if (result == VertexCutResult::Modified) {
+                    vertices_modified = true;
+                    numModifiedVertices++;
                 }
             }
         }
     }
+    return vertices_modified;
+}
 
-    if (vertices_modified) {
-        for (unsigned int i = 0; i < cubeModel.meshes.size(); ++i) {
-            cubeModel.meshes[i].updateVertexBuffer();
+template <typename CutFn>
+long long MillingManager::cutCandidates(size_t count, CutFn&& cutOne) {
+    FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+    writtenCandidates_.clear();
+    if (threadPool_ && count >= PARALLEL_MILLING_MIN_CANDIDATES) {
+        // ÿ̰߳ѽдԼĻкϲ
+        // ÿֻһѡ±̲꣬߳дͬһ㣻ִ˳޹أ
+        // ޸Ϊͣ˲봮еĽȫͬ
+        workerWritten_.resize(threadPool_->size());
+        workerModifiedCount_.assign(threadPool_->size(), 0);
+        for (std::vector<uint32_t>& written : workerWritten_) {
+            written.clear();
+        }
+        threadPool_->parallelFor(count, PARALLEL_MILLING_GRAIN_SIZE, [&](size_t begin, size_t end, unsigned worker) {
+            std::vector<uint32_t>& written = workerWritten_[worker];
+            long long modified = 0;
+            for (size_t i = begin; i < end; ++i) {
+                VertexCutResult result = cutOne(i);
+                if (result != VertexCutResult::Untouched) {
+                    written.push_back(static_cast<uint32_t>(i));
+                }
+                if (result == VertexCutResult::Modified) {
+                    modified++;
+                }
+            }
+            workerModifiedCount_[worker] += modified;
+        });
+        long long modified = 0;
+        for (unsigned worker = 0; worker < workerWritten_.size(); ++worker) {
+            writtenCandidates_.insert(writtenCandidates_.end(), workerWritten_[worker].begin(), workerWritten_[worker].end());
+            modified += workerModifiedCount_[worker];
         }
+        return modified;
     }
-    return vertices_modified;
-} 
\ No newline at end of file
+
+    long long modified = 0;
+    for (size_t i = 0; i < count; ++i) {
+        VertexCutResult result = cutOne(i);
+        if (result != VertexCutResult::Untouched) {
+            writtenCandidates_.push_back(static_cast<uint32_t>(i));
+        }
+        if (result == VertexCutResult::Modified) {
+            modified++;
+        }
+    }
+    return modified;
+}
+
+void MillingManager::reserveCandidateBuffers() {
+    candidateVertices_.clear();
+    candidateIndices_.clear();
+    candidateVertices_.reserve(CANDIDATE_BUFFER_RESERVE);
+    candidateIndices_.reserve(CANDIDATE_BUFFER_RESERVE);
+    lastCandidateCount_ = 0;
+}
+
+void MillingManager::markVertexDirty(Model& cubeModel, const Vertex* vertex) {
+    for (Mesh& mesh : cubeModel.meshes) {
+        if (vertex >= mesh.vertices.data() && vertex < mesh.vertices.data() + mesh.vertices.size()) {
+            mesh.markVertexDirty(static_cast<size_t>(vertex - mesh.vertices.data()));
+            return;
+        }
+    }
+}
+
+template <typename Profile>
+bool MillingManager::processSweptMilling(Model& cubeModel,
+                                         const Profile& profile,
+                                         const glm::vec3& sweepStartLocal,
+                                         const glm::vec3& sweepEndLocal) {
+    // ɨXZƽϵİΧΣ߶ΰΧչһ߰뾶
+    glm::vec2 minXZ(std::min(sweepStartLocal.x, sweepEndLocal.x) - toolRadius_,
+                    std::min(sweepStartLocal.z, sweepEndLocal.z) - toolRadius_);
+    glm::vec2 maxXZ(std::max(sweepStartLocal.x, sweepEndLocal.x) + toolRadius_,
+                    std::max(sweepStartLocal.z, sweepEndLocal.z) + toolRadius_);
+
+    long long modified_count = 0;
+
+    if (spatialIndex_) {
+        // ƶֻѯһοռ󲽳СĲѯͬ
+#if ENABLE_SOA_LEAF_QUERY
+        {
+            FrameProfiler::Scope queryScope(FrameProfiler::QuadtreeQuery);
+            candidateIndices_.clear();
+            spatialIndex_->queryRectIndices(minXZ, maxXZ, candidateIndices_);
+        }
+        numVertices += candidateIndices_.size();
+        modified_count = cutCandidates(candidateIndices_.size(), [&](size_t i) {
+            uint32_t mesh_index, vertex_index;
+            spatialIndex_->resolveIndex(candidateIndices_[i], mesh_index, vertex_index);
+            return cutVertexSwept(profile, cubeModel.meshes[mesh_index].vertices[vertex_index], sweepStartLocal, sweepEndLocal);
+        });
+        for (uint32_t candidate : writtenCandidates_) {
+            uint32_t mesh_index, vertex_index;
+            spatialIndex_->resolveIndex(candidateIndices_[candidate], mesh_index, vertex_index);
+            cubeModel.meshes[mesh_index].markVertexDirty(vertex_index);
+        }
+#else
+        if (!threadPool_ || lastCandidateCount_ < PARALLEL_MILLING_MIN_CANDIDATES) {
+            // ԤƲᲢɨӷΧһĺѡƣ
+            // Ҷɨֱɺѡ顣ѯʱ CutKernel FrameProfiler::Phase
+            FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+            size_t candidate_count = 0;
+            spatialIndex_->visitRect(minXZ, maxXZ, [&](Vertex* vertex) {
+                candidate_count++;
+                VertexCutResult result = cutVertexSwept(profile, *vertex, sweepStartLocal, sweepEndLocal);
+                if (result != VertexCutResult::Untouched) {
+                    markVertexDirty(cubeModel, vertex);
+                }
+                if (result == VertexCutResult::Modified) {
+                    modified_count++;
+                }
+            });
+            lastCandidateCount_ = candidate_count;
+        } else {
+            // Ҫ±Ѻѡֿ飬ȰѲѯд븴õĻ
+            {
+                FrameProfiler::Scope queryScope(FrameProfiler::QuadtreeQuery);
+                candidateVertices_.clear();
+                spatialIndex_->queryRect(minXZ, maxXZ, candidateVertices_);
+            }
+            lastCandidateCount_ = candidateVertices_.size();
+            modified_count = cutCandidates(candidateVertices_.size(), [&](size_t i) {
+                return cutVertexSwept(profile, *candidateVertices_[i], sweepStartLocal, sweepEndLocal);
+            });
+            for (uint32_t candidate : writtenCandidates_) {
+                markVertexDirty(cubeModel, candidateVertices_[candidate]);
+            }
+        }
+        numVertices += lastCandidateCount_;
+#endif
+    } else {
+        for (Mesh& current_mesh : cubeModel.meshes) {
+            std::vector<Vertex>& vertices = current_mesh.vertices;
+            modified_count += cutCandidates(vertices.size(), [&](size_t i) {
+                Vertex& current_vertex = vertices[i];
+                // ðΧοųȷɨж
+                if (current_vertex.Position.x < minXZ.x || current_vertex.Position.x > maxXZ.x ||
+                    current_vertex.Position.z < minXZ.y || current_vertex.Position.z > maxXZ.y) {
+                    return VertexCutResult::Untouched;
+                }
+                return cutVertexSwept(profile, current_vertex, sweepStartLocal, sweepEndLocal);
+            });
+            for (uint32_t candidate : writtenCandidates_) {
+                current_mesh.markVertexDirty(candidate);
+            }
+        }
+    }
+    numModifiedVertices += modified_count;
+    return modified_count > 0;
+}
+
+template <typename Profile>
+bool MillingManager::sweptCutHeight(const Profile& profile,
+                                    float x, float z,
+                                    const glm::vec3& sweepStartLocal,
+                                    const glm::vec3& sweepEndLocal,
+                                    float& cutY,
+                                    glm::vec3& toolTipLocal) const {
+    const float radius_squared = toolRadius_ * toolRadius_;
+
+    // XZƽϵĵ켣߶ a -> a + abt_proj Ϊ߶ֱϵͶӰ
+    glm::vec2 ab(sweepEndLocal.x - sweepStartLocal.x, sweepEndLocal.z - sweepStartLocal.z);
+    glm::vec2 ap(x - sweepStartLocal.x, z - sweepStartLocal.z);
+    float seg_len_squared = glm::dot(ab, ab);
+    float t_proj = (seg_len_squared > 1e-12f) ? glm::dot(ap, ab) / seg_len_squared : 0.0f;
+    float t_closest = glm::clamp(t_proj, 0.0f, 1.0f);
+
+    // 㵽߶ε벻Сڵ߰뾶ʱƶеõ
+    glm::vec2 closest_offset = ap - ab * t_closest;
+    if (glm::dot(closest_offset, closest_offset) >= radius_squared) {
+        return false;
+    }
+
+    // 󵶾ڸǸõһƶУеλӦĲ t_cut
+    // ˮƽƶʱ㣻Z򣨾ֲYбƶҪ߶ƫơ
+    float t_cut = t_closest;
+    float seg_len = std::sqrt(seg_len_squared);
+    float dy = sweepEndLocal.y - sweepStartLocal.y;
+    if (seg_len > 1e-6f && dy != 0.0f) {
+        glm::vec2 perp_offset = ap - ab * t_proj;
+        float perp_dist_squared = glm::dot(perp_offset, perp_offset);
+        // ߸Ǹõʱ߶οƶİҳ
+        float half_chord = std::sqrt(glm::max(radius_squared - perp_dist_squared, 0.0f));
+        // ͶӰ߶ηƫƾ룬ɵ״
+        float along = profile.lowestAlong(dy / seg_len, perp_dist_squared, half_chord);
+        t_cut = glm::clamp(t_proj + along / seg_len, 0.0f, 1.0f);
+    }
+
+    toolTipLocal = glm::mix(sweepStartLocal, sweepEndLocal, t_cut);
+    float dx = x - toolTipLocal.x;
+    float dz = z - toolTipLocal.z;
+    float dist_xz_squared = glm::min(dx * dx + dz * dz, radius_squared);
+    cutY = toolTipLocal.y + profile.heightAt(dist_xz_squared); // Lowest point of tool is toolTipLocal.y
+    return true;
+}
+
+template <typename Profile>
+MillingManager::VertexCutResult MillingManager::cutVertexPoint(const Profile& profile, Vertex& vertex, const glm::vec3& toolTipLocal) const {
+    // ռֻҶӻԪ񷵻غѡʱľǱҪģȷԲβѯǳ
+    float dx = vertex.Position.x - toolTipLocal.x;
+    float dz = vertex.Position.z - toolTipLocal.z;
+    float dist_xz_squared = dx * dx + dz * dz;
+    if (dist_xz_squared >= toolRadius_ * toolRadius_) {
+        return VertexCutResult::Untouched;
+    }
+    float actual_cut_y = glm::max(toolTipLocal.y + profile.heightAt(dist_xz_squared), cubeMinLocalY_);
+    if (vertex.Position.y <= actual_cut_y) {
+        return VertexCutResult::Untouched;
+    }
+
+    float old_y = vertex.Position.y;
+    vertex.Position.y = actual_cut_y;
+    vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f); // Set color to red
+    vertex.Normal = profile.normalAt(vertex.Position - toolTipLocal);
+    // Check if Y actually changed
+    return std::abs(vertex.Position.y - old_y) > 0.00001f ? VertexCutResult::Modified : VertexCutResult::Written;
+}
+
+template <typename Profile>
+MillingManager::VertexCutResult MillingManager::cutVertexSwept(const Profile& profile,
+                                    Vertex& vertex,
+                                    const glm::vec3& sweepStartLocal,
+                                    const glm::vec3& sweepEndLocal) const {
+    float cut_y;
+    glm::vec3 tool_tip;
+    if (!sweptCutHeight(profile, vertex.Position.x, vertex.Position.z, sweepStartLocal, sweepEndLocal, cut_y, tool_tip)) {
+        return VertexCutResult::Untouched;
+    }
+    float actual_cut_y = glm::max(cut_y, cubeMinLocalY_);
+    if (vertex.Position.y <= actual_cut_y) {
+        return VertexCutResult::Untouched;
+    }
+
+    float old_y = vertex.Position.y;
+    vertex.Position.y = actual_cut_y;
+    vertex.Color = glm::vec3(1.0f, 1.0f, 1.0f);
+    vertex.Normal = profile.normalAt(vertex.Position - tool_tip);
+    // Check if Y actually changed
+    return std::abs(vertex.Position.y - old_y) > 0.00001f ? VertexCutResult::Modified : VertexCutResult::Written;
+}
+
+template <typename Profile>
+bool MillingManager::processHeightFieldMilling(const Profile& profile,
+                                               const glm::vec3& sweepStartLocal,
+                                               const glm::vec3& sweepEndLocal) {
+    FrameProfiler::Scope cutScope(FrameProfiler::CutKernel);
+    HeightFieldCutStats stats;
+    if (sweepStartLocal == sweepEndLocal) {
+        // ״ʵѭ
+        stats = heightField_->cutPoint(sweepEndLocal, profile);
+    } else {
+        glm::vec2 minXZ(std::min(sweepStartLocal.x, sweepEndLocal.x) - toolRadius_,
+                        std::min(sweepStartLocal.z, sweepEndLocal.z) - toolRadius_);
+        glm::vec2 maxXZ(std::max(sweepStartLocal.x, sweepEndLocal.x) + toolRadius_,
+                        std::max(sweepStartLocal.z, sweepEndLocal.z) + toolRadius_);
+        stats = heightField_->cutRegion(minXZ, maxXZ, [&](float x, float z, float& cutY) {
+            glm::vec3 tool_tip;
+            return sweptCutHeight(profile, x, z, sweepStartLocal, sweepEndLocal, cutY, tool_tip);
+        });
+    }
+    numVertices += stats.visited;
+    numModifiedVertices += stats.modified;
+    return stats.modified > 0;
+}
@@ -4,19 +4,18 @@
 #include <learnopengl/model.h>
 #include <glm/glm.hpp>
 #include <memory> // For std::unique_ptr
+#include <string>
+#include "cutter_profile.h"
 
 // Forward declaration
-class Quadtree;
+class ISpatialIndex; // 涥Ŀռʵְѡ񣨼 spatial_index.h
+class HeightFieldStock;
+class ThreadPool;
 
 // ԽЩΪMillingManagerĳԱͨ캯
 // const float DEFAULT_TOOL_RADIUS = 0.1f;
 // const float DEFAULT_TOOL_TIP_LOCAL_Y_OFFSET = 0.39f;
 // const float DEFAULT_CUBE_MIN_LOCAL_Y = -0.3f;
-enum ToolType
-{
-    flat,
-    ball,
-};
 class MillingManager {
 public:
     MillingManager(float toolRadius = 0.01f,    // ߰뾶
@@ -27,22 +26,58 @@ public:
 
     // ڵλöcubeModelϳ
     // κζ㱻޸ģ򷵻true
+    // passedCubePositions: һεë;λã PathManager::GetPassedWaypoints
+    // ɨʱ һεĵ -> ; -> ǰ 
     bool processMilling(Model& cubeModel,
                         const glm::vec3& cubeWorldPosition,
                         const glm::vec3& toolBaseWorldPosition,
-                        bool isMillingEnabled);
+                        bool isMillingEnabled,
+                        const std::vector<glm::vec3>* passedCubePositions = nullptr);
+
+    // ѡռʵ֣Ƽ spatialIndexNames()"none" ʾ
+    //  initializeSpatialPartition / restoreSpatialPartition ֮ǰãδ֪ʱ false
+    // Ĭֵ Method.h  ENABLE_QUADTREE_OPTIMIZATIONENABLE_LINEAR_QUADTREE ȿؾ
+    bool setSpatialIndex(const std::string& name);
+    const std::string& getSpatialIndexName() const { return spatialIndexName_; }
 
-    // ·ʼռṹ (Ĳ)
+    // ·ʼռṹ (setSpatialIndex ѡĲ)
     // surfaceYValue: ʶ涥Yοֵ
     // surfaceYThreshold: YsurfaceYValueֵ
     // quadtreeMaxLevels: Ĳ (3㣬Լ64Ҷӽڵ)
     // quadtreeMaxVertsPerNode: ÿҶӽڵڷǰ󶥵
+    // ʹĲʱԺ
     void initializeSpatialPartition(Model& cubeModel, 
                                     float surfaceYValue, 
                                     float surfaceYThreshold, 
                                     int quadtreeMaxLevels, 
                                     int quadtreeMaxVertsPerNode);
 
+    // 棨 StockCacheѽõĿռд outûֻ֧ʱ false
+    // 񽨵úܿ죬棩
+    bool serializeSpatialPartition(const Model& cubeModel, std::vector<char>& out) const;
+    // ӻݻָǰѡĿռcubeModel дʱһ£ initializeSpatialPartition
+    // Чʱ falseӦΪ½
+    bool restoreSpatialPartition(Model& cubeModel, const char* data, size_t size);
+
+    // ʼ߶ȳZ-mapëɵ滻 cubeModel ԭе
+    // surfaceYValue: ëϱĳʼ߶
+    // resolutionX / resolutionZ: ߶ȳXZ
+    void initializeHeightField(Model& cubeModel,
+                               float surfaceYValue,
+                               int resolutionX,
+                               int resolutionZ);
+
+    // õͼ״ ToolShape߰뾶䡣ͬʱؽߵĸ߶Ȳұ CutterProfile
+    void setToolShape(const ToolShape& shape);
+    const ToolShape& getToolShape() const { return toolShape_; }
+
+    // һĵλãһ֮һɨӣͷ»ط·ʱ
+    void resetToolPath() { hasLastToolTip_ = false; }
+
+    // Ϊ true ʱ processMilling ϴ㻺壬޸ĹĶֻҳλͼбǣ
+    // ɵߣ̰߳޸ĽȾ̣߳ϴĬ false
+    void setDeferredUpload(bool deferred) { deferredUpload_ = deferred; }
+
     long long int getNumVertices();
     static long long int numVertices;
     static long long int numModifiedVertices;
@@ -51,11 +86,80 @@ private:
     float toolRadius_;
     float toolTipLocalYOffset_;
     float cubeMinLocalY_;
-    ToolType toolheadType_; 
+    ToolShape toolShape_; // ͺ״ÿѡһ״ԣ dispatchToolProfile
+    CutterProfile cutter_; //  toolShape_  toolRadius_ ͨõߣƽ׵ͷĵ߲ı
     float Y_ball_center;
     float new_Y;
+
+    // ɨ¼һʱëֲϵµλ
+    glm::vec3 lastToolTipLocal_;
+    bool hasLastToolTip_;
+
+    bool deferredUpload_ = false;
+
+    // ״ Profile tool_profile.hʵѭвжϵ
+
+    // λ toolTipLocal ʱĵпռʱֻʺѡ㣬ж㣩
+    template <typename Profile>
+    bool processPointMilling(Model& cubeModel, const Profile& profile, const glm::vec3& toolTipLocal);
+    //  sweepStartLocal ƶ sweepEndLocal ɨ
+    template <typename Profile>
+    bool processSweptMilling(Model& cubeModel,
+                             const Profile& profile,
+                             const glm::vec3& sweepStartLocal,
+                             const glm::vec3& sweepEndLocal);
+    // 㵶 sweepStartLocal ƶ sweepEndLocal ĹУ (x, z) е͸߶ȡ
+    // õ㲻ɨͶӰʱfalsetoolTipLocal ȡ͸߶ʱĵλ
+    template <typename Profile>
+    bool sweptCutHeight(const Profile& profile,
+                        float x, float z,
+                        const glm::vec3& sweepStartLocal,
+                        const glm::vec3& sweepEndLocal,
+                        float& cutY,
+                        glm::vec3& toolTipLocal) const;
+    // 
+    enum class VertexCutResult {
+        Untouched, // Χڣѵ߶
+        Written,   // 㱻д룬߶ȱ仯Ժԣ numModifiedVertices
+        Modified,  // ߶ȷ仯
+    };
+    // λ toolTipLocal ʱԵ
+    template <typename Profile>
+    VertexCutResult cutVertexPoint(const Profile& profile, Vertex& vertex, const glm::vec3& toolTipLocal) const;
+    // Եɨµ߶Ȳ޸Ķ
+    template <typename Profile>
+    VertexCutResult cutVertexSwept(const Profile& profile,
+                        Vertex& vertex,
+                        const glm::vec3& sweepStartLocal,
+                        const glm::vec3& sweepEndLocal) const;
     
-    std::unique_ptr<Quadtree> quadtree_; // ʹָĲ
+    // ± [0, count) ÿѡ cutOne VertexCutResultдĺѡ±
+    //  writtenCandidates_ڱҳظ߶ȷ仯Ķʱ̳߳طִֿ
+    template <typename CutFn>
+    long long cutCandidates(size_t count, CutFn&& cutOne);
+    // ΪѯԤָռ֮ã
+    void reserveCandidateBuffers();
+    // ڶҳλͼбǸö
+    void markVertexDirty(Model& cubeModel, const Vertex* vertex);
+
+
+    // ڸ߶ȳëֹͬʱΪ
+    template <typename Profile>
+    bool processHeightFieldMilling(const Profile& profile,
+                                   const glm::vec3& sweepStartLocal,
+                                   const glm::vec3& sweepEndLocal);
+
+    std::string spatialIndexName_;
+    std::unique_ptr<ISpatialIndex> spatialIndex_; // Ϊʱж
+    std::unique_ptr<HeightFieldStock> heightField_; // ߶ȳëΪʱֱ޸ Mesh 
+    std::unique_ptr<ThreadPool> threadPool_; // Ḷ́߳Ϊʱ
+    // ռѯĸûÿβѯǰգڽʱԤʱٷڴ
+    std::vector<Vertex*> candidateVertices_;
+    std::vector<uint32_t> candidateIndices_;
+    size_t lastCandidateCount_ = 0; // һɨĺѡжһǷֵò
+    std::vector<uint32_t> writtenCandidates_; // cutCandidates Ľ
+    std::vector<std::vector<uint32_t>> workerWritten_; // ÿ̸߳Լ¼Ľ
+    std::vector<long long> workerModifiedCount_;
 };
 
 #endif // MILLING_MANAGER_H 
\ No newline at end of file
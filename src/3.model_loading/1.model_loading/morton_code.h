@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 // Z/Mortonعߺ
 namespace MortonCode {
@@ -27,12 +29,28 @@ namespace MortonCode {
         return x;
     }
 
+    // part1by1 㣺ȡżλѹ32λ
+    inline uint32_t compact1by1(uint64_t x) {
+        x &= 0x5555555555555555;
+        x = (x | (x >> 1)) & 0x3333333333333333;
+        x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0F;
+        x = (x | (x >> 4)) & 0x00FF00FF00FF00FF;
+        x = (x | (x >> 8)) & 0x0000FFFF0000FFFF;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFF;
+        return static_cast<uint32_t>(x);
+    }
+
     // 32λά꣩Ϊһ64λMorton롣
     // XλռżλZλռλ
     inline uint64_t encode(uint32_t x, uint32_t z) {
         return (part1by1(x) << 1) | part1by1(z);
     }
     
+    // Morton뻹ԭά꣬.x ΪX꣬.y ΪZ
+    inline glm::uvec2 decode(uint64_t code) {
+        return glm::uvec2(compact1by1(code >> 1), compact1by1(code));
+    }
+    
     // -------------------------------------------------------------------------------------
     // תıݺ
     // -------------------------------------------------------------------------------------
@@ -83,22 +101,34 @@ namespace MortonCode {
     // Morton뷶Χѯĺ
     // -------------------------------------------------------------------------------------
 
+    // ׷һMorton䣻ݹ鰴Z˳УһβʱֱӺϲ
+    inline void appendMortonRange(uint64_t first, uint64_t last, std::vector<std::pair<uint64_t, uint64_t>>& ranges) {
+        if (!ranges.empty() && ranges.back().second + 1 == first) {
+            ranges.back().second = last;
+        } else {
+            ranges.emplace_back(first, last);
+        }
+    }
+
     // ݹزҸ2Dѯ1D Morton뷶Χ
     // 'code': ǰ½ǵMorton롣
     // 'level': ǰ޵ļ𣨴16ʼռ䣬0Ԫ񣩡
     // 'q_min', 'q_max': ѯε귶Χ
     // 's_min', 's_max': ǰ޵귶Χ
     // 'ranges': ڴ洢Χ
+    // 'minLevel': ݹ鵽üϸཻ֣
+    //             ǲѯεĳȷжϣα߳
     inline void getMortonRanges(
         uint64_t code, int level,
         const glm::uvec2& q_min, const glm::uvec2& q_max,
         const glm::uvec2& s_min, const glm::uvec2& s_max,
-        std::vector<std::pair<uint64_t, uint64_t>>& ranges)
+        std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+        int minLevel = 0)
     {
         // 1. ȫڲѯڣMorton뷶ΧҪĽ
         if (s_min.x >= q_min.x && s_max.x <= q_max.x && s_min.y >= q_min.y && s_max.y <= q_max.y) {
             uint64_t size = 1ULL << (2 * level); // ˼ް
-            ranges.emplace_back(code, code + size - 1);
+            appendMortonRange(code, code + size - 1, ranges);
             return;
         }
 
@@ -108,16 +138,51 @@ namespace MortonCode {
         }
 
         // 3. ཻһٷ֣ݹ鵽ĸޡ
-        if (level > 0) {
+        if (level > minLevel) {
             int next_level = level - 1;
             uint64_t quadrant_size = 1ULL << (2 * next_level); // ÿ޵
             uint32_t half_dim = 1U << next_level; // ޵ı߳
 
             // Zߵ˳ݹ (SW -> NW -> SE -> NE)
-            getMortonRanges(code,                       next_level, q_min, q_max, s_min,                                         {s_min.x + half_dim - 1, s_min.y + half_dim - 1}, ranges);
-            getMortonRanges(code + quadrant_size,       next_level, q_min, q_max, {s_min.x, s_min.y + half_dim},                 {s_min.x + half_dim - 1, s_max.y},                ranges);
-            getMortonRanges(code + 2 * quadrant_size,   next_level, q_min, q_max, {s_min.x + half_dim, s_min.y},                 {s_max.x, s_min.y + half_dim - 1},                ranges);
-            getMortonRanges(code + 3 * quadrant_size,   next_level, q_min, q_max, {s_min.x + half_dim, s_min.y + half_dim},      s_max,                                            ranges);
+            getMortonRanges(code,                       next_level, q_min, q_max, s_min,                                         {s_min.x + half_dim - 1, s_min.y + half_dim - 1}, ranges, minLevel);
+            getMortonRanges(code + quadrant_size,       next_level, q_min, q_max, {s_min.x, s_min.y + half_dim},                 {s_min.x + half_dim - 1, s_max.y},                ranges, minLevel);
+            getMortonRanges(code + 2 * quadrant_size,   next_level, q_min, q_max, {s_min.x + half_dim, s_min.y},                 {s_max.x, s_min.y + half_dim - 1},                ranges, minLevel);
+            getMortonRanges(code + 3 * quadrant_size,   next_level, q_min, q_max, {s_min.x + half_dim, s_min.y + half_dim},      s_max,                                            ranges, minLevel);
+        } else {
+            // 4. ﵽϸԲཻΪѡ
+            uint64_t size = 1ULL << (2 * level);
+            appendMortonRange(code, code + size - 1, ranges);
+        }
+    }
+
+    // 㸲 [q_min, q_max] Morton䣨16λռ䣩
+    // ϸּݾγߴԶѡʹڳ
+    //  getMortonRanges ռϸֵ minLevel ཻͬ minLevel ޵Ĳ
+    // ڸüา 5 x 5 ޣֱöٺMortonϲ𼶵ݹ֦
+    inline void getMortonRangesForRect(const glm::uvec2& q_min, const glm::uvec2& q_max,
+                                       std::vector<std::pair<uint64_t, uint64_t>>& ranges) {
+        uint32_t extent = (std::max)(q_max.x - q_min.x, q_max.y - q_min.y) + 1;
+        int extentLevel = 0;
+        while (extentLevel < 16 && (1U << extentLevel) < extent) {
+            ++extentLevel;
+        }
+        // ϸȡѯα߳Լ1/4ÿ౻гɼ
+        int minLevel = (std::max)(extentLevel - 2, 0);
+
+        const size_t MAX_CELLS = 25;
+        uint64_t cells[MAX_CELLS];
+        size_t cellCount = 0;
+        for (uint32_t cz = q_min.y >> minLevel; cz <= (q_max.y >> minLevel); ++cz) {
+            for (uint32_t cx = q_min.x >> minLevel; cx <= (q_max.x >> minLevel); ++cx) {
+                cells[cellCount++] = encode(cx, cz);
+            }
+        }
+        std::sort(cells, cells + cellCount);
+
+        const int shift = 2 * minLevel;
+        const uint64_t size = 1ULL << shift; // ÿް
+        for (size_t i = 0; i < cellCount; ++i) {
+            appendMortonRange(cells[i] << shift, (cells[i] << shift) + size - 1, ranges);
         }
     }
 
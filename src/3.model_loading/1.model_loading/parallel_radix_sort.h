@@ -0,0 +1,87 @@
+#ifndef PARALLEL_RADIX_SORT_H
+#define PARALLEL_RADIX_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+//  (, ֵ) еļȶ LSD ÿ˴ 8 λֻĵ keyBits λ
+// гɿ飬ÿȲͳƸֱͼٰ (, ) ˳дλòзַ
+// ͬԪرԭ˳pool Ϊʱڵִ߳С
+namespace ParallelRadixSort {
+
+    const int RADIX_BITS = 8;
+    const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+    // Ԫڸʱֿ飨̵߳Ŀ
+    const size_t MIN_CHUNK_SIZE = 16384;
+
+    template <typename Value>
+    void sortByKey(std::vector<std::pair<uint64_t, Value>>& items, int keyBits, ThreadPool* pool) {
+        using Item = std::pair<uint64_t, Value>;
+        const size_t count = items.size();
+        if (count < 2 || keyBits <= 0) {
+            return;
+        }
+        size_t chunkCount = 1;
+        if (pool && count >= 2 * MIN_CHUNK_SIZE) {
+            chunkCount = (std::min)(size_t(pool->size()) * 4, count / MIN_CHUNK_SIZE);
+        }
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+        auto forEachChunk = [&](const ThreadPool::RangeFn& body) {
+            if (chunkCount == 1) {
+                body(0, 1, 0);
+            } else {
+                pool->parallelFor(chunkCount, 1, body);
+            }
+        };
+
+        std::vector<Item> buffer(count);
+        std::vector<size_t> offsets(chunkCount * RADIX_BUCKETS); // [][]
+        Item* source = items.data();
+        Item* target = buffer.data();
+        for (int shift = 0; shift < keyBits; shift += RADIX_BITS) {
+            // 1. ֱͼ
+            forEachChunk([&](size_t firstChunk, size_t lastChunk, unsigned) {
+                for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                    size_t* histogram = &offsets[chunk * RADIX_BUCKETS];
+                    std::fill(histogram, histogram + RADIX_BUCKETS, size_t(0));
+                    const size_t end = (std::min)(count, (chunk + 1) * chunkSize);
+                    for (size_t i = chunk * chunkSize; i < end; ++i) {
+                        ++histogram[(source[i].first >> shift) & (RADIX_BUCKETS - 1)];
+                    }
+                }
+            });
+
+            // 2. ִСͬһڰ˳дλã֤ȶ
+            size_t position = 0;
+            for (size_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+                for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                    size_t bucketCount = offsets[chunk * RADIX_BUCKETS + digit];
+                    offsets[chunk * RADIX_BUCKETS + digit] = position;
+                    position += bucketCount;
+                }
+            }
+
+            // 3. ԪطַĿ
+            forEachChunk([&](size_t firstChunk, size_t lastChunk, unsigned) {
+                for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                    size_t* next = &offsets[chunk * RADIX_BUCKETS];
+                    const size_t end = (std::min)(count, (chunk + 1) * chunkSize);
+                    for (size_t i = chunk * chunkSize; i < end; ++i) {
+                        target[next[(source[i].first >> shift) & (RADIX_BUCKETS - 1)]++] = source[i];
+                    }
+                }
+            });
+            std::swap(source, target);
+        }
+        if (source != items.data()) {
+            items.swap(buffer);
+        }
+    }
+}
+
+#endif // PARALLEL_RADIX_SORT_H
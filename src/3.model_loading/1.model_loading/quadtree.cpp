@@ -1,8 +1,15 @@
 #include "quadtree.h"
+#include "parallel_radix_sort.h"
+#include "thread_pool.h"
+#include "Method.h"
+#include <algorithm>
 #include <iostream> // For std::cout in printTreeContents
 
 Quadtree::Quadtree(glm::vec2 minBounds, glm::vec2 maxBounds, int maxLvl, int maxVertsPerNode)
-    : maxLevels(maxLvl), maxVerticesPerNode(maxVertsPerNode) {
+    : maxLevels(maxLvl), maxVerticesPerNode(maxVertsPerNode),
+      zOrderQueryMode(ENABLE_Z_ORDER_RANGE_QUERY ? ZOrderQueryMode::RangeQuery
+                      : ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING ? ZOrderQueryMode::CenterScanPruned
+                      : ZOrderQueryMode::CenterScan) {
     root = new QuadtreeNode(minBounds, maxBounds, 0, this);
 }
 
@@ -17,6 +24,69 @@ void Quadtree::insert(Vertex* vertex) {
     // else: Vertex is outside the bounds of the quadtree, decide how to handle (e.g., ignore, log error)
 }
 
+void Quadtree::bulkLoad(const std::vector<Vertex*>& vertices, ThreadPool* pool) {
+    if (!root) {
+        return;
+    }
+    const glm::vec2 minBounds = root->minBounds;
+    const glm::vec2 maxBounds = root->maxBounds;
+    clear();
+    root = new QuadtreeNode(minBounds, maxBounds, 0, this);
+    if (maxLevels > MAX_BULK_LEVELS) {
+        // ·Ų64λ˻
+        for (Vertex* vertex : vertices) {
+            insert(vertex);
+        }
+        return;
+    }
+
+    // 1. м·룬ڵ㷶Χ֮Ķ㣨 insert һ£
+    const int levels = (std::max)(maxLevels, 0);
+    // ֵΪ vertices е±꣬ҶӾݴ˻ָ˳
+    std::vector<std::pair<uint64_t, uint32_t>> entries(vertices.size());
+    std::vector<uint8_t> inside(vertices.size());
+    auto encode = [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            inside[i] = root->containsPoint(vertices[i]->Position) ? 1 : 0;
+            entries[i] = { inside[i] ? treePathCode(vertices[i]->Position, minBounds, maxBounds, levels) : 0, static_cast<uint32_t>(i) };
+        }
+    };
+    if (pool) {
+        pool->parallelFor(vertices.size(), BULK_LOAD_GRAIN_SIZE, encode);
+    } else {
+        encode(0, vertices.size(), 0);
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (inside[i]) {
+            entries[kept++] = entries[i];
+        }
+    }
+    entries.resize(kept);
+
+    // 2. ·
+    ParallelRadixSort::sortByKey(entries, 2 * levels, pool);
+
+    // 3. ϶»
+    root->buildSorted(entries.data(), entries.size(), vertices.data());
+}
+
+uint64_t Quadtree::treePathCode(const glm::vec3& position, glm::vec2 minBounds, glm::vec2 maxBounds, int levels) {
+    // 㰴 QuadtreeNode::getChildIndex ѡӽڵ㣬ӽڵ߽簴 subdivide ķʽ㡣
+    // ʹMorton룬Ϊǡڷֽ߸Ķ insert ͬһӽڵ
+    uint64_t code = 0;
+    for (int level = 0; level < levels; ++level) {
+        glm::vec2 center = minBounds + (maxBounds - minBounds) / 2.0f;
+        bool top = position.z >= center.y;
+        bool left = position.x < center.x;
+        uint64_t child = top ? (left ? 0 : 1) : (left ? 2 : 3);
+        if (top) minBounds.y = center.y; else maxBounds.y = center.y;
+        if (left) maxBounds.x = center.x; else minBounds.x = center.x;
+        code = (code << 2) | child;
+    }
+    return code;
+}
+
 void Quadtree::optimize() {
     if (root) {
         root->optimize();
@@ -25,10 +95,103 @@ void Quadtree::optimize() {
 
 std::vector<Vertex*> Quadtree::queryRange(const glm::vec2& center, float radius) const {
     std::vector<Vertex*> resultVertices;
+    queryRange(center, radius, resultVertices);
+    return resultVertices;
+}
+
+std::vector<Vertex*> Quadtree::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<Vertex*> resultVertices;
+    queryRect(minXZ, maxXZ, resultVertices);
+    return resultVertices;
+}
+
+std::vector<uint32_t> Quadtree::queryRangeIndices(const glm::vec2& center, float radius) const {
+    std::vector<uint32_t> resultIndices;
+    queryRangeIndices(center, radius, resultIndices);
+    return resultIndices;
+}
+
+std::vector<uint32_t> Quadtree::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<uint32_t> resultIndices;
+    queryRectIndices(minXZ, maxXZ, resultIndices);
+    return resultIndices;
+}
+
+void Quadtree::queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const {
     if (root) {
         root->queryRange(center, radius, resultVertices);
     }
-    return resultVertices;
+}
+
+void Quadtree::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const {
+    if (root) {
+        root->queryRect(minXZ, maxXZ, resultVertices);
+    }
+}
+
+void Quadtree::queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const {
+    if (root) {
+        root->queryRangeIndices(center, radius, resultIndices);
+    }
+}
+
+void Quadtree::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const {
+    if (root) {
+        root->queryRectIndices(minXZ, maxXZ, resultIndices);
+    }
+}
+
+void Quadtree::visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const {
+    if (root) {
+        root->visitRange(center, radius, visitor);
+    }
+}
+
+void Quadtree::visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const {
+    if (root) {
+        root->visitRect(minXZ, maxXZ, visitor);
+    }
+}
+
+void Quadtree::bindMeshes(const std::vector<Mesh>& meshes) {
+    vertexIndexer.bind(meshes);
+}
+
+void Quadtree::resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const {
+    vertexIndexer.resolve(globalIndex, meshIndex, vertexIndex);
+}
+
+void Quadtree::writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const {
+    writer.write(static_cast<int32_t>(maxLevels));
+    writer.write(static_cast<int32_t>(maxVerticesPerNode));
+    writer.write(root->minBounds);
+    writer.write(root->maxBounds);
+    root->writeCache(writer, indexer);
+}
+
+bool Quadtree::readCache(BlobReader& reader, std::vector<Mesh>& meshes) {
+    int32_t levels = 0, vertsPerNode = 0;
+    glm::vec2 minBounds, maxBounds;
+    reader.read(levels);
+    reader.read(vertsPerNode);
+    reader.read(minBounds);
+    reader.read(maxBounds);
+    if (!reader.ok()) {
+        return false;
+    }
+    clear();
+    maxLevels = levels;
+    maxVerticesPerNode = vertsPerNode;
+    root = new QuadtreeNode(minBounds, maxBounds, 0, this);
+
+    MeshVertexIndexer indexer;
+    indexer.bind(meshes);
+    if (!root->readCache(reader, meshes, indexer)) {
+        clear();
+        root = new QuadtreeNode(minBounds, maxBounds, 0, this);
+        return false;
+    }
+    return true;
 }
 
 void Quadtree::clear() {
@@ -2,34 +2,84 @@
 #define QUADTREE_H
 
 #include "quadtree_node.h"
+#include "binary_blob.h"
 #include <vector>
 #include <glm/glm.hpp>
+
+class ThreadPool;
 // #include <learnopengl/mesh.h> // Vertex is included via quadtree_node.h
 
 class Quadtree {
 public:
+    // ZҶӵԲβѯʽĬֵ Method.h  ENABLE_Z_ORDER_RANGE_QUERY /
+    // ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING ʱ޸ԱԱȣ
+    enum class ZOrderQueryMode {
+        RangeQuery,       // ѲѯԲİΧвΪMorton䣬ֲ
+        CenterScan,       // ĵMortonɨҶ
+        CenterScanPruned, // ͬϣX볬뾶ʱǰʽ©㣩
+    };
+
     QuadtreeNode* root;
     int maxLevels;
     int maxVerticesPerNode; // Ҷӽڵڷǰɵ󶥵
+    ZOrderQueryMode zOrderQueryMode;
 
     // 캯Ҫض㼯XZ߽
     Quadtree(glm::vec2 minBounds, glm::vec2 maxBounds, int maxLvl, int maxVertsPerNode);
     ~Quadtree();
 
     void insert(Vertex* vertex);
+    //  verticesмÿе·루ÿ2λ subdivide ӽڵ
+    // ˳һ£϶°ǰ׺ֳڵ㣬һνɣͷѡ
+    // Ҷڶ˳밴ͬ˳ insert ȫͬpool Ϊʱм
+    void bulkLoad(const std::vector<Vertex*>& vertices, ThreadPool* pool);
     // ѯԲཻĶ (XZƽ)
     std::vector<Vertex*> queryRange(const glm::vec2& center, float radius) const;
+    // ѯڸڵĶ (XZƽ)ɨʱһȡ·İΧ
+    std::vector<Vertex*> queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // ѯԶŷأ MeshVertexIndexerֻȡҶӵSoAݣ Vertex*
+    std::vector<uint32_t> queryRangeIndices(const glm::vec2& center, float radius) const;
+    std::vector<uint32_t> queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // Ĳѯͬѽ׷ӵߵĩβգ
+    // ÿβѯǰ clear() ͬһ飬úѯٷڴ
+    void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const;
+    void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const;
+    void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const;
+    void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const;
+    // صʽҶɨжԷΧڵÿֱӵ visitorɽ
+    void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const;
+    void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const;
 
-    // ҶӽڵZŻ
+    // ¼֮ optimize() ΪÿҶӹSoA
+    void bindMeshes(const std::vector<Mesh>& meshes);
+    // ѲѯصĶŻΪ±ڵĶ±
+    void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const;
+
+    // ҶӽڵZŻѰʱͬʱSoAݣ
     void optimize();
 
     void clear(); // ɾнڵͶָ룩
 
+    // 棨 StockCacheдṹ͸ҶӵĶţindexer ȫֱţ
+    // ȡʱֱӻָڵZЧʱ false
+    void writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const;
+    bool readCache(BlobReader& reader, std::vector<Mesh>& meshes);
+
     // ӡ (ڵ)
     void printTreeContents() const;
 
+    MeshVertexIndexer vertexIndexer; //  bindMeshes 
+
+    // bulkLoad ·ÿ2λ
+    static constexpr int MAX_BULK_LEVELS = 31;
+    static constexpr size_t BULK_LOAD_GRAIN_SIZE = 8192;
+
 private:
     void clearRecursive(QuadtreeNode* node);
+    // Ӹڵ㵽 levels ·0ӽڵλ
+    static uint64_t treePathCode(const glm::vec3& position, glm::vec2 minBounds, glm::vec2 maxBounds, int levels);
 };
 
 #endif // QUADTREE_H 
\ No newline at end of file
@@ -1,11 +1,18 @@
 #include "quadtree_node.h"
-#include "quadtree.h" // Ҫ Quadtree  maxLevels  maxVerticesPerNode
+#include "quadtree.h" // Ҫ Quadtree  maxLevelsmaxVerticesPerNode  zOrderQueryMode
 #include <algorithm> // For std::max and std::min for intersection checks, and std::sort
 #include <iostream> // For std::cout
-#include "Method.h"
+
+namespace {
+    // ڴֵZҶֱɨSoA飺MortonͶֲҵĹ̶
+    // ɨ輸ٸ껹ߣmill_bench ÿҶԼ300ʱ߳ƽ
+    const size_t Z_RANGE_QUERY_MIN_VERTICES = 512;
+    // ֲҵһԤķ֧ + ǰһķô棩൱ɨ輸ĺʱ
+    const size_t RANGE_SEARCH_STEP_COST = 2;
+}
 
 QuadtreeNode::QuadtreeNode(glm::vec2 minB, glm::vec2 maxB, int lvl, Quadtree* ownerTree)
-    : minBounds(minB), maxBounds(maxB), level(lvl), tree(ownerTree), isZSorted(false) {
+    : minBounds(minB), maxBounds(maxB), level(lvl), tree(ownerTree), isZSorted(false), soaIndexed(false) {
     for (int i = 0; i < 4; ++i) {
         children[i] = nullptr;
     }
@@ -58,6 +65,35 @@ void QuadtreeNode::subdivide() {
     }
 }
 
+void QuadtreeNode::buildSorted(std::pair<uint64_t, uint32_t>* entries, size_t count, Vertex* const* sourceVertices) {
+    //  insert ͬķδﵽ㼶
+    if (count <= (size_t)tree->maxVerticesPerNode || level >= tree->maxLevels) {
+        // λδҶӰ±Իָ˳ insert Ľһ£
+        // Ҷӱȫͬȶǲ˳
+        if (level < tree->maxLevels) {
+            std::sort(entries, entries + count,
+                [](const auto& a, const auto& b) { return a.second < b.second; });
+        }
+        vertices.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            vertices.push_back(sourceVertices[entries[i].second]);
+        }
+        return;
+    }
+
+    subdivide(); // ǰڵûж㣬ֻӽڵ
+    const int shift = 2 * (tree->maxLevels - level - 1);
+    size_t begin = 0;
+    for (int i = 0; i < 4; ++i) {
+        size_t end = begin;
+        while (end < count && static_cast<int>((entries[end].first >> shift) & 3) == i) {
+            ++end;
+        }
+        children[i]->buildSorted(entries + begin, end - begin, sourceVertices);
+        begin = end;
+    }
+}
+
 void QuadtreeNode::insert(Vertex* vertex) {
     if (!containsPoint(vertex->Position)) {
         return; // 㲻ڴ˽ڵ߽
@@ -117,6 +153,132 @@ void QuadtreeNode::optimize() {
         
         // std::cout << "Optimized a leaf node with " << zSortedVertices.size() << " vertices using Z-order curve." << std::endl;
     }
+
+    // ѰZʱSoAݡֻ޸ĶY꣬�XZʼЧ
+    soaIndexed = tree->vertexIndexer.isBound();
+    if (soaIndexed || isZSorted) {
+        size_t count = isZSorted ? zSortedVertices.size() : vertices.size();
+        soaPoints.clear();
+        soaPoints.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Vertex* vertex = isZSorted ? zSortedVertices[i].second : vertices[i];
+            uint32_t index = 0;
+            if (soaIndexed) {
+                tree->vertexIndexer.indexOf(vertex, index);
+            }
+            soaPoints.push_back(vertex->Position.x, vertex->Position.z, index);
+        }
+        soaPoints.finalize();
+    }
+}
+
+template <typename VisitSpanFn>
+void QuadtreeNode::forEachZSortedSpanInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitSpanFn&& visitSpan) const {
+    // 0. ҶӽСʱֱӷҶӣ䱾ǲѯεĳ߶ȷжϣ
+    const size_t count = zSortedVertices.size();
+    if (count < Z_RANGE_QUERY_MIN_VERTICES) {
+        visitSpan(size_t(0), count);
+        return;
+    }
+
+    // 1. ѲѯʱͬϵҶӵĲֱضϵ߽ϣ
+    glm::uvec2 qMin = MortonCode::quantizePosition({minXZ.x, 0.0f, minXZ.y}, minBounds, maxBounds);
+    glm::uvec2 qMax = MortonCode::quantizePosition({maxXZ.x, 0.0f, maxXZ.y}, minBounds, maxBounds);
+
+    // 2. ΪɸMorton䣬䰴
+    thread_local std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    ranges.clear();
+    MortonCode::getMortonRangesForRect(qMin, qMax, ranges);
+
+    // 3. ÿҪζֲҡѯθҶӵĴ󲿷֡ҵĴ۳ɨҶʱֱͬɨ
+    size_t searchSteps = 1;
+    while ((size_t(1) << searchSteps) < count) {
+        ++searchSteps;
+    }
+    if (ranges.size() * 2 * searchSteps * RANGE_SEARCH_STEP_COST >= count) {
+        visitSpan(size_t(0), count);
+        return;
+    }
+
+    // 4. ÿֲյ㣬õ zSortedVertices еһ±
+    auto first = zSortedVertices.begin();
+    for (const auto& range : ranges) {
+        first = std::lower_bound(first, zSortedVertices.end(), range.first,
+            [](const std::pair<uint64_t, Vertex*>& element, uint64_t value) {
+                return element.first < value;
+            });
+        auto last = std::upper_bound(first, zSortedVertices.end(), range.second,
+            [](uint64_t value, const std::pair<uint64_t, Vertex*>& element) {
+                return value < element.first;
+            });
+        if (first != last) {
+            visitSpan(static_cast<size_t>(first - zSortedVertices.begin()), static_cast<size_t>(last - zSortedVertices.begin()));
+        }
+        first = last;
+        if (first == zSortedVertices.end()) {
+            break;
+        }
+    }
+}
+
+template <typename VisitFn>
+void QuadtreeNode::forEachZSortedInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const {
+    forEachZSortedSpanInRect(minXZ, maxXZ, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            visit(zSortedVertices[i].second);
+        }
+    });
+}
+
+template <typename InsideFn, typename VisitFn>
+void QuadtreeNode::forEachZSortedMatchInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, InsideFn&& inside, VisitFn&& visit) const {
+    if (soaPoints.count != zSortedVertices.size()) {
+        // ûSoAݣȡûе optimizeֱӷʶ
+        forEachZSortedInRect(minXZ, maxXZ, [&](Vertex* vertex) {
+            if (inside(vertex->Position.x, vertex->Position.z)) {
+                visit(vertex);
+            }
+        });
+        return;
+    }
+    const float* xs = soaPoints.xs.data();
+    const float* zs = soaPoints.zs.data();
+    forEachZSortedSpanInRect(minXZ, maxXZ, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (inside(xs[i], zs[i])) {
+                visit(zSortedVertices[i].second);
+            }
+        }
+    });
+}
+
+template <typename SoaFn, typename VertexFn>
+void QuadtreeNode::queryLeafIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, SoaFn&& testSoa, VertexFn&& testVertex,
+                                    std::vector<uint32_t>& resultIndices) const {
+    if (soaIndexed && soaPoints.count > 0) {
+        // SoA zSortedVertices ˳һ£MortonֱΪSoA±
+        if (isZSorted) {
+            forEachZSortedSpanInRect(minXZ, maxXZ, testSoa);
+        } else {
+            testSoa(size_t(0), soaPoints.count);
+        }
+        return;
+    }
+
+    // δSoAݣδδŻж϶Ϊ
+    auto visit = [&](Vertex* vertex) {
+        uint32_t index;
+        if (testVertex(vertex) && tree->vertexIndexer.indexOf(vertex, index)) {
+            resultIndices.push_back(index);
+        }
+    };
+    if (isZSorted) {
+        forEachZSortedInRect(minXZ, maxXZ, visit);
+    } else {
+        for (Vertex* vertex : vertices) {
+            visit(vertex);
+        }
+    }
 }
 
 // ǷڽڵXZ߽
@@ -155,16 +317,67 @@ bool QuadtreeNode::intersectsCircle(const glm::vec2& center, float radius) const
     return (distanceX * distanceX + distanceZ * distanceZ) <= (radius * radius);
 }
 
-void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const {
+// ѯǷ˽ڵıཻ߽
+bool QuadtreeNode::intersectsRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    return !(maxXZ.x < minBounds.x || minXZ.x > maxBounds.x ||
+             maxXZ.y < minBounds.y || minXZ.y > maxBounds.y); // .y is Z
+}
+
+template <typename VisitFn>
+void QuadtreeNode::forEachInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const {
+    if (!intersectsRect(minXZ, maxXZ)) {
+        return; // ˽ڵѯΧཻ
+    }
+
+    if (isLeaf()) {
+        auto testVertex = [&](Vertex* vertex) {
+            if (vertex->Position.x >= minXZ.x && vertex->Position.x <= maxXZ.x &&
+                vertex->Position.z >= minXZ.y && vertex->Position.z <= maxXZ.y) {
+                visit(vertex);
+            }
+        };
+        if (isZSorted) {
+            // ZŻ󶥵ֻ zSortedVertices УMortonֻθǵĲ
+            forEachZSortedMatchInRect(minXZ, maxXZ,
+                [&](float x, float z) { return x >= minXZ.x && x <= maxXZ.x && z >= minXZ.y && z <= maxXZ.y; },
+                visit);
+        } else {
+            for (Vertex* vertex : vertices) {
+                testVertex(vertex);
+            }
+        }
+    } else {
+        // ڲڵ㣬ݹѯӽڵ
+        for (int i = 0; i < 4; ++i) {
+            if (children[i]) {
+                children[i]->forEachInRect(minXZ, maxXZ, visit);
+            }
+        }
+    }
+}
+
+template <typename VisitFn>
+void QuadtreeNode::forEachInRange(const glm::vec2& center, float radius, VisitFn&& visit) const {
     if (!intersectsCircle(center, radius)) {
         return; // ˽ڵѯΧཻ
     }
 
     if (isLeaf()) {
         // ǾZŻҶӽڵ
-        if (isZSorted) {
+        if (isZSorted && tree->zOrderQueryMode == Quadtree::ZOrderQueryMode::RangeQuery) {
+            // --- Mortonѯ·ֻԲİΧиǵ䣬뵶߸ ---
+            const float radiusSq = radius * radius;
+            forEachZSortedMatchInRect(center - glm::vec2(radius), center + glm::vec2(radius),
+                [&](float x, float z) {
+                    float dx = x - center.x;
+                    float dz = z - center.y;
+                    return (dx * dx + dz * dz) <= radiusSq;
+                },
+                visit);
+        } else if (isZSorted) {
             // --- "ɢ"ѯ· (bug) ---
             const float radiusSq = radius * radius;
+            const bool heuristicPruning = tree->zOrderQueryMode == Quadtree::ZOrderQueryMode::CenterScanPruned;
 
             // 1. ѯĵMorton
             uint64_t centerCode = MortonCode::getMortonCodeFromCoord(
@@ -184,15 +397,13 @@ void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector
                 float dx = vertex->Position.x - center.x;
                 float dz = vertex->Position.z - center.y;
                 if ((dx * dx + dz * dz) <= radiusSq) {
-                    resultVertices.push_back(vertex);
+                    visit(vertex);
                 } else {
                     // ʽ֦һXϵľѾ˲ѯ뾶
                     // ôĵԲڵĿԾͺСˣΪZX򣩡
-#if ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING
-                    if (std::abs(dx) > radius) {
+                    if (heuristicPruning && std::abs(dx) > radius) {
                         break;
                     }
-#endif
                 }
             }
             
@@ -202,13 +413,11 @@ void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector
                 float dx = vertex->Position.x - center.x;
                 float dz = vertex->Position.z - center.y;
                 if ((dx * dx + dz * dz) <= radiusSq) {
-                    resultVertices.push_back(vertex);
+                    visit(vertex);
                 } else {
-#if ENABLE_Z_ORDER_QUERY_HEURISTIC_PRUNING
-                    if (std::abs(dx) > radius) {
+                    if (heuristicPruning && std::abs(dx) > radius) {
                         break;
                     }
-#endif
                 }
             }
         } else {
@@ -218,7 +427,7 @@ void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector
                 float dx = vertex->Position.x - center.x;
                 float dz = vertex->Position.z - center.y;
                 if ((dx * dx + dz * dz) <= radiusSq) {
-                    resultVertices.push_back(vertex);
+                    visit(vertex);
                 }
             }
         }
@@ -226,12 +435,155 @@ void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector
         // ڲڵ㣬ݹѯӽڵ
         for (int i = 0; i < 4; ++i) {
             if (children[i]) {
-                children[i]->queryRange(center, radius, resultVertices);
+                children[i]->forEachInRange(center, radius, visit);
             }
         }
     }
 }
 
+void QuadtreeNode::queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const {
+    forEachInRange(center, radius, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void QuadtreeNode::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const {
+    forEachInRect(minXZ, maxXZ, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void QuadtreeNode::visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const {
+    forEachInRange(center, radius, visitor);
+}
+
+void QuadtreeNode::visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const {
+    forEachInRect(minXZ, maxXZ, visitor);
+}
+
+void QuadtreeNode::queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const {
+    if (!intersectsCircle(center, radius)) {
+        return; // ˽ڵѯΧཻ
+    }
+
+    if (isLeaf()) {
+        const float radiusSq = radius * radius;
+        queryLeafIndices(center - glm::vec2(radius), center + glm::vec2(radius),
+            [&](size_t begin, size_t end) {
+                SoaPointQuery::queryCircle(soaPoints, begin, end, center, radiusSq, resultIndices);
+            },
+            [&](const Vertex* vertex) {
+                float dx = vertex->Position.x - center.x;
+                float dz = vertex->Position.z - center.y;
+                return (dx * dx + dz * dz) <= radiusSq;
+            },
+            resultIndices);
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            if (children[i]) {
+                children[i]->queryRangeIndices(center, radius, resultIndices);
+            }
+        }
+    }
+}
+
+void QuadtreeNode::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const {
+    if (!intersectsRect(minXZ, maxXZ)) {
+        return; // ˽ڵѯΧཻ
+    }
+
+    if (isLeaf()) {
+        queryLeafIndices(minXZ, maxXZ,
+            [&](size_t begin, size_t end) {
+                SoaPointQuery::queryRect(soaPoints, begin, end, minXZ, maxXZ, resultIndices);
+            },
+            [&](const Vertex* vertex) {
+                return vertex->Position.x >= minXZ.x && vertex->Position.x <= maxXZ.x &&
+                       vertex->Position.z >= minXZ.y && vertex->Position.z <= maxXZ.y;
+            },
+            resultIndices);
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            if (children[i]) {
+                children[i]->queryRectIndices(minXZ, maxXZ, resultIndices);
+            }
+        }
+    }
+}
+
+void QuadtreeNode::writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const {
+    writer.write(static_cast<uint8_t>(isLeaf() ? 1 : 0));
+    if (!isLeaf()) {
+        for (int i = 0; i < 4; ++i) {
+            children[i]->writeCache(writer, indexer);
+        }
+        return;
+    }
+
+    writer.write(static_cast<uint8_t>(isZSorted ? 1 : 0));
+    const size_t count = isZSorted ? zSortedVertices.size() : vertices.size();
+    std::vector<uint32_t> indices(count);
+    std::vector<uint64_t> codes;
+    for (size_t i = 0; i < count; ++i) {
+        indexer.indexOf(isZSorted ? zSortedVertices[i].second : vertices[i], indices[i]);
+    }
+    writer.writeVector(indices);
+    if (isZSorted) {
+        codes.reserve(count);
+        for (const auto& entry : zSortedVertices) {
+            codes.push_back(entry.first);
+        }
+        writer.writeVector(codes);
+    }
+}
+
+bool QuadtreeNode::readCache(BlobReader& reader, std::vector<Mesh>& meshes, const MeshVertexIndexer& indexer) {
+    uint8_t leaf = 0;
+    if (!reader.read(leaf)) {
+        return false;
+    }
+    if (!leaf) {
+        // ӽڵı߽ subdivide() ͬķʽ㣬뽨ʱȫһ£սڵѲκζ㣩
+        subdivide();
+        if (isLeaf()) {
+            return false; // Ĳ뵱ǰ
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (!children[i]->readCache(reader, meshes, indexer)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint8_t zSorted = 0;
+    std::vector<uint32_t> indices;
+    std::vector<uint64_t> codes;
+    reader.read(zSorted);
+    reader.readVector(indices);
+    if (zSorted) {
+        reader.readVector(codes);
+    }
+    if (!reader.ok() || (zSorted && codes.size() != indices.size())) {
+        return false;
+    }
+
+    isZSorted = zSorted != 0;
+    if (isZSorted) {
+        zSortedVertices.reserve(indices.size());
+    } else {
+        vertices.reserve(indices.size());
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        Vertex* vertex = indexer.vertexAt(meshes, indices[i]);
+        if (!vertex) {
+            return false;
+        }
+        if (isZSorted) {
+            zSortedVertices.emplace_back(codes[i], vertex);
+        } else {
+            vertices.push_back(vertex);
+        }
+    }
+    return true;
+}
+
 void QuadtreeNode::printVertices(int indentLevel) const {
     std::string indent(indentLevel * 2, ' '); // ַ
 
@@ -7,6 +7,9 @@
 #include <glm/glm.hpp>
 #include <learnopengl/mesh.h> // For Vertex struct
 #include "morton_code.h"      // µMorton빤
+#include "soa_point_query.h"
+#include "binary_blob.h"
+#include "vertex_visitor.h"
 
 // ǰ
 class Quadtree;
@@ -29,23 +32,46 @@ public:
     std::vector<std::pair<uint64_t, Vertex*>> zSortedVertices; // 洢MortonĶ
     // --- ZŻԱ ---
 
+    // ҶӵSoAݣ optimize() й˳ zSortedVerticesδʱΪ verticesһ¡
+    // ZҶǹָѯеXZжϣذMorton˳ Vertex
+    // ֻȵ Quadtree::bindMeshes ʱЧsoaIndexedδҶҲֻʱ
+    SoaPoints soaPoints;
+    bool soaIndexed;
+
     QuadtreeNode(glm::vec2 minB, glm::vec2 maxB, int lvl, Quadtree* ownerTree);
     ~QuadtreeNode();
 
     bool isLeaf() const;
     void insert(Vertex* vertex);
     void subdivide();
+    //  Quadtree::bulkLoad ãentries Ϊ˽ڵ㷶Χڰ· (, vertices ±)
+    // δʱѣ2λļνӽڵ
+    void buildSorted(std::pair<uint64_t, uint32_t>* entries, size_t count, Vertex* const* sourceVertices);
     
     // Դ˽ڵ㼰ӽڵZŻ
     void optimize();
     
-    // ѯԲཻĶ
+    // ѯԲཻĶ㣨׷ӵ resultVertices
     void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const;
-    
+    // ѯڸڵĶ㣨׷ӵ resultVertices
+    void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const;
+    // ѯͬҶɨжÿֱӵ visitor
+    void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const;
+    void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const;
+    // ѯͬضţҶѹSoAʱʹж
+    void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const;
+    void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const;
+
     // һǷڴ˽ڵı߽ (XZƽ)
     bool containsPoint(const glm::vec3& pointPosition) const;
     // һԲǷ˽ڵıཻ߽ (XZƽ)
     bool intersectsCircle(const glm::vec2& center, float radius) const;
+    // һǷ˽ڵıཻ߽ (XZƽ)
+    bool intersectsRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // 棺д/ȡ˽ڵ㼰ӽڵ㣨 Quadtree::writeCache
+    void writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const;
+    bool readCache(BlobReader& reader, std::vector<Mesh>& meshes, const MeshVertexIndexer& indexer);
 
     // ӡ˽ڵ㼰ӽڵ洢ĶϢ (ڵ)
     void printVertices(int indentLevel = 0) const;
@@ -53,6 +79,25 @@ public:
 private:
     // ȡڵӽڵ
     int getChildIndex(const glm::vec3& pointPosition) const;
+
+    // Բ / βѯı֣ԷΧڵÿ visit
+    template <typename VisitFn>
+    void forEachInRange(const glm::vec2& center, float radius, VisitFn&& visit) const;
+    template <typename VisitFn>
+    void forEachInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const;
+    // ZҶУֻMortonھ [minXZ, maxXZ] ڵĶ
+    template <typename VisitFn>
+    void forEachZSortedInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitFn&& visit) const;
+    // ͬϣSoAеж inside(x, z)ֻͨжϵĶ visit
+    template <typename InsideFn, typename VisitFn>
+    void forEachZSortedMatchInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, InsideFn&& inside, VisitFn&& visit) const;
+    //  zSortedVertices ± [begin, end) ΪλصҶӽС϶ʱҶӣȷжϣ
+    template <typename VisitSpanFn>
+    void forEachZSortedSpanInRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitSpanFn&& visitSpan) const;
+    // ŲѯҶӲ֣testSoa SoAеһΣtestVertex δSoAݵĶ
+    template <typename SoaFn, typename VertexFn>
+    void queryLeafIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, SoaFn&& testSoa, VertexFn&& testVertex,
+                          std::vector<uint32_t>& resultIndices) const;
 };
 
 #endif // QUADTREE_NODE_H 
\ No newline at end of file
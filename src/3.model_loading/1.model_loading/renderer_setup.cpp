@@ -1,5 +1,6 @@
 #include "renderer_setup.h"
 #include <iostream> //  std::cout
+#include <cstring>  //  strcmp
 
 // Forward declaration if needed, or include the header that provides it.
 // For stbi_set_flip_vertically_on_load:
@@ -68,4 +69,27 @@ void configureGlobalOpenGLState()
     // ͨڼκģ֮ǰһΡ
     stbi_set_flip_vertically_on_load(true);
     glEnable(GL_DEPTH_TEST);
-}
\ No newline at end of file
+}
+
+bool initBufferStorage()
+{
+    if (GLAD_GL_VERSION_4_4 && glBufferStorage != nullptr)
+    {
+        return true;
+    }
+
+    // İ汾4.4ʱglad  glBufferStorageҪչֶ
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; ++i)
+    {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && strcmp(name, "GL_ARB_buffer_storage") == 0)
+        {
+            glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+            return glBufferStorage != nullptr;
+        }
+    }
+    std::cout << "GL_ARB_buffer_storage is not supported" << std::endl;
+    return false;
+}
@@ -20,4 +20,9 @@ bool initGLAD();
 // ȫOpenGL״̬
 void configureGlobalOpenGLState();
 
+// Ƿ֧ glBufferStorageOpenGL 4.4  GL_ARB_buffer_storage չ
+// ֻչʱGLFWغָ
+// ֵ: ֧ glBufferStorage ʱ true
+bool initBufferStorage();
+
 #endif // RENDERER_SETUP_H 
\ No newline at end of file
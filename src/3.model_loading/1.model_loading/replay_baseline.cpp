@@ -0,0 +1,102 @@
+#include "replay_baseline.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+uint64_t ReplayBaseline::hashVertexHeights(const Model& model) {
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const Mesh& mesh : model.meshes) {
+        for (const Vertex& vertex : mesh.vertices) {
+            uint32_t bits;
+            std::memcpy(&bits, &vertex.Position.y, sizeof(bits));
+            for (int byte = 0; byte < 4; ++byte) {
+                hash ^= (bits >> (byte * 8)) & 0xFF;
+                hash *= FNV_PRIME;
+            }
+        }
+    }
+    return hash;
+}
+
+bool ReplayBaseline::load(const std::string& path, ReplayResult& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t separator = line.find('=');
+        if (line.empty() || line[0] == '#' || separator == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, separator);
+        std::istringstream value(line.substr(separator + 1));
+        if (key == "toolpath") baseline.toolpath = value.str();
+        else if (key == "dt") value >> baseline.timeStep;
+        else if (key == "steps") value >> baseline.steps;
+        else if (key == "wall_ms") value >> baseline.wallMs;
+        else if (key == "candidate_vertices") value >> baseline.candidateVertices;
+        else if (key == "modified_vertices") value >> baseline.modifiedVertices;
+        else if (key == "height_hash") value >> std::hex >> baseline.heightHash;
+    }
+    return true;
+}
+
+bool ReplayBaseline::save(const std::string& path, const ReplayResult& result) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "# headless replay baseline" << std::endl;
+    file << "toolpath=" << result.toolpath << std::endl;
+    file << std::setprecision(9) << "dt=" << result.timeStep << std::endl; // غ뱾βȷȽ
+    file << "steps=" << result.steps << std::endl;
+    file << std::fixed << std::setprecision(3) << "wall_ms=" << result.wallMs << std::endl;
+    file << "candidate_vertices=" << result.candidateVertices << std::endl;
+    file << "modified_vertices=" << result.modifiedVertices << std::endl;
+    file << "height_hash=" << std::hex << std::setw(16) << std::setfill('0') << result.heightHash << std::endl;
+    return static_cast<bool>(file);
+}
+
+bool ReplayBaseline::compare(const ReplayResult& baseline, const ReplayResult& current, double timeTolerance) {
+    bool passed = true;
+    std::cout << "======== Replay Baseline Comparison ========" << std::endl;
+    if (baseline.toolpath != current.toolpath || baseline.timeStep != current.timeStep) {
+        std::cout << "FAIL  settings: baseline was recorded with toolpath '" << baseline.toolpath << "', dt " << baseline.timeStep
+                  << "; this run used '" << current.toolpath << "', dt " << current.timeStep << std::endl;
+        return false;
+    }
+
+    if (baseline.steps != current.steps) {
+        std::cout << "FAIL  steps: " << baseline.steps << " -> " << current.steps << std::endl;
+        passed = false;
+    }
+    if (baseline.heightHash != current.heightHash) {
+        std::cout << "FAIL  stock heights differ: " << std::hex << baseline.heightHash << " -> " << current.heightHash << std::dec << std::endl;
+        passed = false;
+    } else {
+        std::cout << "OK    stock heights identical (" << std::hex << current.heightHash << std::dec << ")" << std::endl;
+    }
+
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1);
+    double timeRatio = baseline.wallMs > 0.0 ? current.wallMs / baseline.wallMs : 1.0;
+    bool slower = timeRatio > 1.0 + timeTolerance;
+    std::cout << (slower ? "FAIL  " : "OK    ") << "wall time: " << baseline.wallMs << " ms -> " << current.wallMs
+              << " ms (" << (timeRatio - 1.0) * 100.0 << "%, tolerance " << timeTolerance * 100.0 << "%)" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(precision);
+    if (slower) {
+        passed = false;
+    }
+
+    std::cout << "INFO  candidate vertices: " << baseline.candidateVertices << " -> " << current.candidateVertices << std::endl;
+    std::cout << "INFO  modified vertices: " << baseline.modifiedVertices << " -> " << current.modifiedVertices << std::endl;
+    std::cout << (passed ? "Replay matches the baseline." : "Replay does NOT match the baseline.") << std::endl;
+    return passed;
+}
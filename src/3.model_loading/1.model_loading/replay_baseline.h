@@ -0,0 +1,34 @@
+#ifndef REPLAY_BASELINE_H
+#define REPLAY_BASELINE_H
+
+#include <cstdint>
+#include <string>
+#include <learnopengl/model.h>
+
+// һ޴ڻطţ̶ë + ̶· + ̶Ľ
+struct ReplayResult {
+    std::string toolpath;      // GļΪձʾ·
+    float timeStep = 0.0f;     // 0 ʾ SIMULATION_STEP_MM Ĳ
+    size_t steps = 0;
+    double wallMs = 0.0;
+    long long candidateVertices = 0; // MillingManager::numVertices
+    long long modifiedVertices = 0;  // MillingManager::numModifiedVertices
+    uint64_t heightHash = 0;         // ն߶ȵ FNV-1a ϣ
+};
+
+// طŻߣһλطŵٶΪıļ֮Ļط֮Ƚϡ
+// ߶ȹϣȫһ£ʱ timeTolerance Բ
+// ѡռ仮ַʽ죬ֻӡ仯ж
+class ReplayBaseline {
+public:
+    // Ͷ˳ж Position.y  FNV-1a ϣ
+    static uint64_t hashVertexHeights(const Model& model);
+
+    static bool load(const std::string& path, ReplayResult& baseline);
+    static bool save(const std::string& path, const ReplayResult& result);
+
+    // ӡȽϽһ»ݲʱ false
+    static bool compare(const ReplayResult& baseline, const ReplayResult& current, double timeTolerance);
+};
+
+#endif // REPLAY_BASELINE_H
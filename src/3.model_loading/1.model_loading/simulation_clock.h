@@ -0,0 +1,42 @@
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+// ̶ķʱӣÿ֡ʵʱۼ̶ķ沽Ӳ
+// ʹ֡ʡֱͬ޹ءÿ֡׷ maxStepsPerFrame 
+// ʱֱӶԽ׷Խ
+class SimulationClock {
+public:
+    SimulationClock(float stepSeconds, int maxStepsPerFrame)
+        : stepSeconds_(stepSeconds), maxStepsPerFrame_(maxStepsPerFrame) {}
+
+    // ÿ֡浱ǰٶȱ仯ۻʱ䱣
+    void setStepSeconds(float stepSeconds) { stepSeconds_ = stepSeconds; }
+    float getStepSeconds() const { return stepSeconds_; }
+
+    // ۼһ֡ʵʱ䣬ر֡Ҫִеķ沽
+    int advance(float frameSeconds) {
+        if (stepSeconds_ <= 0.0f) {
+            return 0;
+        }
+        accumulator_ += frameSeconds;
+        int steps = static_cast<int>(accumulator_ / stepSeconds_);
+        if (steps > maxStepsPerFrame_) {
+            droppedSeconds_ += accumulator_ - maxStepsPerFrame_ * stepSeconds_;
+            accumulator_ = 0.0f;
+            return maxStepsPerFrame_;
+        }
+        accumulator_ -= steps * stepSeconds_;
+        return steps;
+    }
+
+    // ׷޶ʵʱ
+    float getDroppedSeconds() const { return droppedSeconds_; }
+
+private:
+    float stepSeconds_;
+    int maxStepsPerFrame_;
+    float accumulator_ = 0.0f;
+    float droppedSeconds_ = 0.0f;
+};
+
+#endif // SIMULATION_CLOCK_H
@@ -0,0 +1,240 @@
+#ifndef SOA_POINT_QUERY_H
+#define SOA_POINT_QUERY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <learnopengl/mesh.h> // For Vertex / Mesh
+#include "aligned_allocator.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// ĲҶӵĽṹ飨SoAݣֻѯҪ XZ Ͷš
+// жʱٽ Vertex*һһٶֽڣֻõ 8 ֽڣ
+//  xs / zs AVX28· AVX-51216·һж϶㡣
+struct SoaPoints {
+    // һжϵ󶥵AVX-512 Ϊ16·
+    static constexpr size_t LANES = 16;
+    // ֵκβѯλö㹻Զ
+    static constexpr float PADDING = 1e30f;
+
+    std::vector<float, AlignedAllocator<float>> xs;
+    std::vector<float, AlignedAllocator<float>> zs;
+    std::vector<uint32_t, AlignedAllocator<uint32_t>> vertexIndex; // MeshVertexIndexer ȫֶ
+    size_t count = 0; // Чĩβ
+
+    void clear() {
+        xs.clear();
+        zs.clear();
+        vertexIndex.clear();
+        count = 0;
+    }
+
+    void reserve(size_t n) {
+        xs.reserve(n + 2 * LANES);
+        zs.reserve(n + 2 * LANES);
+        vertexIndex.reserve(n + 2 * LANES);
+    }
+
+    void push_back(float x, float z, uint32_t index) {
+        xs.push_back(x);
+        zs.push_back(z);
+        vertexIndex.push_back(index);
+        ++count;
+    }
+
+    // ĩβ䣺Ч±꿪ʼ LANES ԪضԽ
+    void finalize() {
+        size_t padded = ((count + LANES - 1) / LANES + 1) * LANES;
+        xs.resize(padded, PADDING);
+        zs.resize(padded, PADDING);
+        vertexIndex.resize(padded, 0);
+    }
+};
+
+//  Vertex* Ϊģڵȫֶţ m ĵ i Ϊ offset[m] + i
+// ѯֻرţͨ resolve ҵ±ꡣ
+class MeshVertexIndexer {
+public:
+    void bind(const std::vector<Mesh>& meshes) {
+        ranges_.clear();
+        uint32_t offset = 0;
+        for (const Mesh& mesh : meshes) {
+            ranges_.push_back({ mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()), offset });
+            offset += static_cast<uint32_t>(mesh.vertices.size());
+        }
+    }
+
+    bool isBound() const { return !ranges_.empty(); }
+
+    // 㲻κѰʱfalse
+    bool indexOf(const Vertex* vertex, uint32_t& globalIndex) const {
+        for (const MeshRange& range : ranges_) {
+            if (vertex >= range.base && vertex < range.base + range.count) {
+                globalIndex = range.offset + static_cast<uint32_t>(vertex - range.base);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void resolve(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const {
+        // ģֻͨһ򼸸ԲҼ
+        meshIndex = 0;
+        while (meshIndex + 1 < ranges_.size() && globalIndex >= ranges_[meshIndex + 1].offset) {
+            ++meshIndex;
+        }
+        vertexIndex = globalIndex - ranges_[meshIndex].offset;
+    }
+
+    // ŶӦĶ㣨meshes Ϊ bind ʱ񣩣ųΧʱ nullptr
+    Vertex* vertexAt(std::vector<Mesh>& meshes, uint32_t globalIndex) const {
+        if (ranges_.empty()) {
+            return nullptr;
+        }
+        uint32_t meshIndex, vertexIndex;
+        resolve(globalIndex, meshIndex, vertexIndex);
+        if (meshIndex >= meshes.size() || vertexIndex >= ranges_[meshIndex].count) {
+            return nullptr;
+        }
+        return &meshes[meshIndex].vertices[vertexIndex];
+    }
+
+private:
+    struct MeshRange {
+        const Vertex* base;
+        uint32_t count;
+        uint32_t offset;
+    };
+    std::vector<MeshRange> ranges_;
+};
+
+//  SoaPoints ± [begin, end) һζԲ/жϣеĶ׷ӵ result
+// ʱ AVX-512 / AVX2 ʹöӦʵ֣ʹñѭ
+namespace SoaPointQuery {
+
+    inline int countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    inline int popCount(uint32_t mask) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt(mask));
+#else
+        return __builtin_popcount(mask);
+#endif
+    }
+
+    // һֻ end ֮ǰͨ
+    inline uint32_t tailMask(size_t remaining, size_t lanes) {
+        return (1u << (remaining < lanes ? remaining : lanes)) - 1;
+    }
+
+    inline void queryCircle(const SoaPoints& points, size_t begin, size_t end,
+                            const glm::vec2& center, float radiusSq,
+                            std::vector<uint32_t>& result) {
+        const float* xs = points.xs.data();
+        const float* zs = points.zs.data();
+        const uint32_t* ids = points.vertexIndex.data();
+#if defined(__AVX512F__)
+        const __m512 cx = _mm512_set1_ps(center.x);
+        const __m512 cz = _mm512_set1_ps(center.y);
+        const __m512 r2 = _mm512_set1_ps(radiusSq);
+        size_t written = result.size();
+        result.resize(written + (end - begin));
+        for (size_t i = begin; i < end; i += 16) {
+            __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(xs + i), cx);
+            __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(zs + i), cz);
+            __m512 d2 = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dz, dz));
+            __mmask16 mask = _mm512_cmp_ps_mask(d2, r2, _CMP_LE_OQ) & static_cast<__mmask16>(tailMask(end - i, 16));
+            _mm512_mask_compressstoreu_epi32(result.data() + written, mask, _mm512_loadu_si512(ids + i));
+            written += popCount(mask);
+        }
+        result.resize(written);
+#elif defined(__AVX2__)
+        const __m256 cx = _mm256_set1_ps(center.x);
+        const __m256 cz = _mm256_set1_ps(center.y);
+        const __m256 r2 = _mm256_set1_ps(radiusSq);
+        for (size_t i = begin; i < end; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), cx);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), cz);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LE_OQ))) & tailMask(end - i, 8);
+            while (mask) {
+                result.push_back(ids[i + countTrailingZeros(mask)]);
+                mask &= mask - 1;
+            }
+        }
+#else
+        for (size_t i = begin; i < end; ++i) {
+            float dx = xs[i] - center.x;
+            float dz = zs[i] - center.y;
+            if ((dx * dx + dz * dz) <= radiusSq) {
+                result.push_back(ids[i]);
+            }
+        }
+#endif
+    }
+
+    inline void queryRect(const SoaPoints& points, size_t begin, size_t end,
+                          const glm::vec2& minXZ, const glm::vec2& maxXZ,
+                          std::vector<uint32_t>& result) {
+        const float* xs = points.xs.data();
+        const float* zs = points.zs.data();
+        const uint32_t* ids = points.vertexIndex.data();
+#if defined(__AVX512F__)
+        const __m512 minX = _mm512_set1_ps(minXZ.x);
+        const __m512 minZ = _mm512_set1_ps(minXZ.y);
+        const __m512 maxX = _mm512_set1_ps(maxXZ.x);
+        const __m512 maxZ = _mm512_set1_ps(maxXZ.y);
+        size_t written = result.size();
+        result.resize(written + (end - begin));
+        for (size_t i = begin; i < end; i += 16) {
+            __m512 x = _mm512_loadu_ps(xs + i);
+            __m512 z = _mm512_loadu_ps(zs + i);
+            __mmask16 mask = _mm512_cmp_ps_mask(x, minX, _CMP_GE_OQ) & _mm512_cmp_ps_mask(x, maxX, _CMP_LE_OQ) &
+                             _mm512_cmp_ps_mask(z, minZ, _CMP_GE_OQ) & _mm512_cmp_ps_mask(z, maxZ, _CMP_LE_OQ) &
+                             static_cast<__mmask16>(tailMask(end - i, 16));
+            _mm512_mask_compressstoreu_epi32(result.data() + written, mask, _mm512_loadu_si512(ids + i));
+            written += popCount(mask);
+        }
+        result.resize(written);
+#elif defined(__AVX2__)
+        const __m256 minX = _mm256_set1_ps(minXZ.x);
+        const __m256 minZ = _mm256_set1_ps(minXZ.y);
+        const __m256 maxX = _mm256_set1_ps(maxXZ.x);
+        const __m256 maxZ = _mm256_set1_ps(maxXZ.y);
+        for (size_t i = begin; i < end; i += 8) {
+            __m256 x = _mm256_loadu_ps(xs + i);
+            __m256 z = _mm256_loadu_ps(zs + i);
+            __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x, minX, _CMP_GE_OQ), _mm256_cmp_ps(x, maxX, _CMP_LE_OQ)),
+                                          _mm256_and_ps(_mm256_cmp_ps(z, minZ, _CMP_GE_OQ), _mm256_cmp_ps(z, maxZ, _CMP_LE_OQ)));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside)) & tailMask(end - i, 8);
+            while (mask) {
+                result.push_back(ids[i + countTrailingZeros(mask)]);
+                mask &= mask - 1;
+            }
+        }
+#else
+        for (size_t i = begin; i < end; ++i) {
+            if (xs[i] >= minXZ.x && xs[i] <= maxXZ.x && zs[i] >= minXZ.y && zs[i] <= maxXZ.y) {
+                result.push_back(ids[i]);
+            }
+        }
+#endif
+    }
+}
+
+#endif // SOA_POINT_QUERY_H
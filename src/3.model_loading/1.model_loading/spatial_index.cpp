@@ -0,0 +1,237 @@
+#include "spatial_index.h"
+#include "quadtree.h"
+#include "linear_quadtree.h"
+#include "uniform_grid_index.h"
+#include <iostream>
+
+namespace {
+    // ԲβѯʽָֻĲѡĲҶӲѯ̶Ϊɨ
+    void setZOrderQueryMode(Quadtree& tree, Quadtree::ZOrderQueryMode mode) {
+        tree.zOrderQueryMode = mode;
+    }
+    void setZOrderQueryMode(LinearQuadtree&, Quadtree::ZOrderQueryMode) {}
+
+    // Quadtree / LinearQuadtreezOrder Ϊ true ʱҶZ򲢹SoA
+    template <typename Tree>
+    class TreeSpatialIndex : public ISpatialIndex {
+    public:
+        TreeSpatialIndex(const char* name, const SpatialIndexParams& params, bool zOrder, Quadtree::ZOrderQueryMode queryMode)
+            : name_(name), params_(params), zOrder_(zOrder), queryMode_(queryMode) {}
+
+        const char* name() const override { return name_; }
+
+        void build(const std::vector<Mesh>& meshes, const std::vector<Vertex*>& vertices,
+                   const glm::vec2& minXZ, const glm::vec2& maxXZ, ThreadPool* pool) override {
+            tree_ = std::make_unique<Tree>(minXZ, maxXZ, params_.quadtreeMaxLevels, params_.quadtreeMaxVertsPerNode);
+            setZOrderQueryMode(*tree_, queryMode_);
+            // м롢һλֳнڵ
+            tree_->bulkLoad(vertices, pool);
+            finish(meshes);
+        }
+
+        void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const override {
+            tree_->queryRange(center, radius, resultVertices);
+        }
+        void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const override {
+            tree_->queryRect(minXZ, maxXZ, resultVertices);
+        }
+        void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const override {
+            tree_->queryRangeIndices(center, radius, resultIndices);
+        }
+        void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const override {
+            tree_->queryRectIndices(minXZ, maxXZ, resultIndices);
+        }
+        void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const override {
+            tree_->resolveIndex(globalIndex, meshIndex, vertexIndex);
+        }
+
+        void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const override {
+            tree_->visitRange(center, radius, visitor);
+        }
+        void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const override {
+            tree_->visitRect(minXZ, maxXZ, visitor);
+        }
+
+        bool writeCache(BlobWriter& writer, const MeshVertexIndexer& indexer) const override {
+            tree_->writeCache(writer, indexer);
+            return true;
+        }
+
+        bool readCache(BlobReader& reader, std::vector<Mesh>& meshes) override {
+            // ߽ͲȲڻУĹֻռλ
+            auto tree = std::make_unique<Tree>(glm::vec2(0.0f), glm::vec2(1.0f), 0, 1);
+            setZOrderQueryMode(*tree, queryMode_);
+            if (!tree->readCache(reader, meshes) || !reader.atEnd()) {
+                return false;
+            }
+            tree_ = std::move(tree);
+            finish(meshes);
+            return true;
+        }
+
+        void printContents() const override {
+            tree_->printTreeContents();
+        }
+
+    private:
+        void finish(const std::vector<Mesh>& meshes) {
+            // ҶӵSoAҪѶ㻻Ϊڵ±꣬ȵǼǶ
+            tree_->bindMeshes(meshes);
+            if (zOrder_) {
+                tree_->optimize();
+            }
+        }
+
+        const char* name_;
+        SpatialIndexParams params_;
+        bool zOrder_;
+        Quadtree::ZOrderQueryMode queryMode_;
+        std::unique_ptr<Tree> tree_;
+    };
+
+    class GridSpatialIndex : public ISpatialIndex {
+    public:
+        explicit GridSpatialIndex(const SpatialIndexParams& params) : cellSize_(params.gridCellSize) {}
+
+        const char* name() const override { return "grid"; }
+
+        void build(const std::vector<Mesh>& meshes, const std::vector<Vertex*>& vertices,
+                   const glm::vec2& minXZ, const glm::vec2& maxXZ, ThreadPool* pool) override {
+            grid_ = std::make_unique<UniformGridIndex>(minXZ, maxXZ, cellSize_);
+            grid_->bindMeshes(meshes);
+            grid_->build(vertices, pool);
+        }
+
+        void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const override {
+            grid_->queryRange(center, radius, resultVertices);
+        }
+        void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const override {
+            grid_->queryRect(minXZ, maxXZ, resultVertices);
+        }
+        void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const override {
+            grid_->queryRangeIndices(center, radius, resultIndices);
+        }
+        void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const override {
+            grid_->queryRectIndices(minXZ, maxXZ, resultIndices);
+        }
+        void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const override {
+            grid_->resolveIndex(globalIndex, meshIndex, vertexIndex);
+        }
+        void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const override {
+            grid_->visitRange(center, radius, visitor);
+        }
+        void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const override {
+            grid_->visitRect(minXZ, maxXZ, visitor);
+        }
+
+        // 񽨵úܿ죬д뻺
+        void printContents() const override {
+            std::cout << "Uniform grid " << grid_->getCellsX() << " x " << grid_->getCellsZ()
+                      << " (cell size " << grid_->getCellSize() << "), " << grid_->size() << " vertices" << std::endl;
+        }
+
+    private:
+        float cellSize_;
+        std::unique_ptr<UniformGridIndex> grid_;
+    };
+
+    // Ķʵ֣б涥XZΪһSoA飬ÿβѯɨȫ
+    class ScanSpatialIndex : public ISpatialIndex {
+    public:
+        const char* name() const override { return "scan"; }
+
+        void build(const std::vector<Mesh>& meshes, const std::vector<Vertex*>& vertices,
+                   const glm::vec2&, const glm::vec2&, ThreadPool*) override {
+            vertexIndexer_.bind(meshes);
+            vertices_ = vertices;
+            points_.clear();
+            points_.reserve(vertices_.size());
+            for (Vertex* vertex : vertices_) {
+                uint32_t index = 0;
+                vertexIndexer_.indexOf(vertex, index);
+                points_.push_back(vertex->Position.x, vertex->Position.z, index);
+            }
+            points_.finalize();
+        }
+
+        void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const override {
+            visitRange(center, radius, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+        }
+        void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const override {
+            visitRect(minXZ, maxXZ, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+        }
+        void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const override {
+            SoaPointQuery::queryCircle(points_, 0, points_.count, center, radius * radius, resultIndices);
+        }
+        void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const override {
+            SoaPointQuery::queryRect(points_, 0, points_.count, minXZ, maxXZ, resultIndices);
+        }
+        void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const override {
+            vertexIndexer_.resolve(globalIndex, meshIndex, vertexIndex);
+        }
+
+        void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const override {
+            const float radiusSq = radius * radius;
+            const float* xs = points_.xs.data();
+            const float* zs = points_.zs.data();
+            for (size_t i = 0; i < points_.count; ++i) {
+                float dx = xs[i] - center.x;
+                float dz = zs[i] - center.y;
+                if ((dx * dx + dz * dz) <= radiusSq) {
+                    visitor(vertices_[i]);
+                }
+            }
+        }
+        void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const override {
+            const float* xs = points_.xs.data();
+            const float* zs = points_.zs.data();
+            for (size_t i = 0; i < points_.count; ++i) {
+                if (xs[i] >= minXZ.x && xs[i] <= maxXZ.x && zs[i] >= minXZ.y && zs[i] <= maxXZ.y) {
+                    visitor(vertices_[i]);
+                }
+            }
+        }
+
+    private:
+        std::vector<Vertex*> vertices_;
+        SoaPoints points_; //  vertices_ һһӦ
+        MeshVertexIndexer vertexIndexer_;
+    };
+}
+
+const std::vector<std::string>& spatialIndexNames() {
+    static const std::vector<std::string> names = {
+        "none", "quadtree", "quadtree-z", "quadtree-z-scan", "quadtree-z-pruned", "linear", "linear-z", "grid", "scan"
+    };
+    return names;
+}
+
+bool isSpatialIndexName(const std::string& name) {
+    for (const std::string& known : spatialIndexNames()) {
+        if (known == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<ISpatialIndex> createSpatialIndex(const std::string& name, const SpatialIndexParams& params) {
+    using Mode = Quadtree::ZOrderQueryMode;
+    if (name == "quadtree")
+        return std::make_unique<TreeSpatialIndex<Quadtree>>("quadtree", params, false, Mode::RangeQuery);
+    if (name == "quadtree-z")
+        return std::make_unique<TreeSpatialIndex<Quadtree>>("quadtree-z", params, true, Mode::RangeQuery);
+    if (name == "quadtree-z-scan")
+        return std::make_unique<TreeSpatialIndex<Quadtree>>("quadtree-z-scan", params, true, Mode::CenterScan);
+    if (name == "quadtree-z-pruned")
+        return std::make_unique<TreeSpatialIndex<Quadtree>>("quadtree-z-pruned", params, true, Mode::CenterScanPruned);
+    if (name == "linear")
+        return std::make_unique<TreeSpatialIndex<LinearQuadtree>>("linear", params, false, Mode::RangeQuery);
+    if (name == "linear-z")
+        return std::make_unique<TreeSpatialIndex<LinearQuadtree>>("linear-z", params, true, Mode::RangeQuery);
+    if (name == "grid")
+        return std::make_unique<GridSpatialIndex>(params);
+    if (name == "scan")
+        return std::make_unique<ScanSpatialIndex>();
+    return nullptr;
+}
@@ -0,0 +1,74 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <learnopengl/mesh.h> // For Vertex / Mesh
+#include "binary_blob.h"
+#include "soa_point_query.h"
+#include "vertex_visitor.h"
+
+class ThreadPool;
+
+// ռʱʹõĲʵֻȡԼҪĲ
+struct SpatialIndexParams {
+    int quadtreeMaxLevels = 3;
+    int quadtreeMaxVertsPerNode = 20; // ÿҶӽڵڷǰ󶥵
+    float gridCellSize = 0.01f;       // ĵԪ߳MillingManager ȡ߰뾶
+};
+
+// 涥ĿռXZƽ棩MillingManager ֻͨýӿڽͲѯ
+// ʵ createSpatialIndex ƴͬһʱлԱȲͬʵ֡
+// ֻ޸ĶYֻ꣬XZ꣬˽֮Ҫ¡
+class ISpatialIndex {
+public:
+    virtual ~ISpatialIndex() = default;
+
+    virtual const char* name() const = 0;
+
+    //  vertices meshes е񣩽֮ǰݱ滻
+    // minXZ / maxXZ ΪЩXZΧpool Ϊʱм
+    virtual void build(const std::vector<Mesh>& meshes, const std::vector<Vertex*>& vertices,
+                       const glm::vec2& minXZ, const glm::vec2& maxXZ, ThreadPool* pool) = 0;
+
+    // ѯԲཻĶ (XZƽ)׷ӵ resultVertices ĩβգ
+    // ߿Ըͬһ飬úѯٷڴ
+    virtual void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const = 0;
+    // ѯڸڵĶ (XZƽ)
+    virtual void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const = 0;
+    // ѯԶ׷ӣ MeshVertexIndexer resolveIndex Ϊ±ڵĶ±
+    virtual void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const = 0;
+    virtual void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const = 0;
+    virtual void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const = 0;
+
+    // صʽĲѯԷΧڵÿ visitorɽ
+    virtual void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const = 0;
+    virtual void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const = 0;
+
+    // 棨 StockCacheֻ֧ʵַ false
+    // readCache  buildЧʱ false
+    virtual bool writeCache(BlobWriter& /*writer*/, const MeshVertexIndexer& /*indexer*/) const { return false; }
+    virtual bool readCache(BlobReader& /*reader*/, std::vector<Mesh>& /*meshes*/) { return false; }
+
+    // ӡ (ڵ)
+    virtual void printContents() const {}
+};
+
+// пѡĿռƣһΪ "none"ʱ񣩣
+//   quadtree           ָĲҶڶ㰴˳ɨ
+//   quadtree-z         ָĲҶӰZԲβѯΪMorton
+//   quadtree-z-scan    ͬϣԲβѯĵMortonɨҶ
+//   quadtree-z-pruned  ͬϣX볬뾶ʱǰɨ裨ʽ©㣩
+//   linear / linear-z  Ĳδ / Z򲢹SoA
+//   grid               񣬵Ԫ߳Ϊ gridCellSize
+//   scan               ɨб涥SoA
+const std::vector<std::string>& spatialIndexNames();
+bool isSpatialIndexName(const std::string& name);
+
+// ƴռδ"none" δ֪Ʒؿָ
+std::unique_ptr<ISpatialIndex> createSpatialIndex(const std::string& name, const SpatialIndexParams& params);
+
+#endif // SPATIAL_INDEX_H
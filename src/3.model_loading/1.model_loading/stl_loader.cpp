@@ -0,0 +1,257 @@
+#include "stl_loader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+namespace {
+
+    constexpr size_t BINARY_HEADER_BYTES = 80;
+    constexpr size_t BINARY_TRIANGLE_BYTES = 50; //  + 3ǵ㣨 3  float+ 2 ֽ
+    constexpr size_t BINARY_TRIANGLES_PER_TASK = 16384;
+    constexpr size_t ASCII_BYTES_PER_TASK = size_t(1) << 20;
+    constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+
+    //  STL ļΨһȷ "solid" ͷĶļҲܾݴʶ
+    bool isBinaryStl(const char* data, size_t size, uint32_t& triangleCount) {
+        if (size < BINARY_HEADER_BYTES + sizeof(uint32_t)) {
+            return false;
+        }
+        std::memcpy(&triangleCount, data + BINARY_HEADER_BYTES, sizeof(uint32_t));
+        return size == BINARY_HEADER_BYTES + sizeof(uint32_t) + size_t(triangleCount) * BINARY_TRIANGLE_BYTES;
+    }
+
+    void parseBinary(const char* data, uint32_t triangleCount, std::vector<glm::vec3>& corners, ThreadPool& pool) {
+        corners.resize(size_t(triangleCount) * 3);
+        const char* triangles = data + BINARY_HEADER_BYTES + sizeof(uint32_t);
+        pool.parallelFor(triangleCount, BINARY_TRIANGLES_PER_TASK, [&](size_t begin, size_t end, unsigned) {
+            for (size_t t = begin; t < end; ++t) {
+                // ļе淨ߣ12 ֽڣɺӺ¼
+                std::memcpy(&corners[t * 3], triangles + t * BINARY_TRIANGLE_BYTES + 12, 3 * sizeof(glm::vec3));
+            }
+        });
+    }
+
+    //  [p, end) ͷĸɴšСָɹʱ p Ƶ֮
+    bool parseFloat(const char*& p, const char* end, float& value) {
+        const char* s = p;
+        bool negative = false;
+        if (s < end && (*s == '+' || *s == '-')) {
+            negative = (*s == '-');
+            ++s;
+        }
+        double mantissa = 0.0;
+        int exponent = 0;
+        bool hasDigits = false;
+        while (s < end && *s >= '0' && *s <= '9') {
+            mantissa = mantissa * 10.0 + (*s - '0');
+            hasDigits = true;
+            ++s;
+        }
+        if (s < end && *s == '.') {
+            ++s;
+            while (s < end && *s >= '0' && *s <= '9') {
+                mantissa = mantissa * 10.0 + (*s - '0');
+                --exponent;
+                hasDigits = true;
+                ++s;
+            }
+        }
+        if (!hasDigits) {
+            return false;
+        }
+        if (s < end && (*s == 'e' || *s == 'E')) {
+            const char* e = s + 1;
+            bool negativeExponent = false;
+            if (e < end && (*e == '+' || *e == '-')) {
+                negativeExponent = (*e == '-');
+                ++e;
+            }
+            if (e < end && *e >= '0' && *e <= '9') {
+                int explicitExponent = 0;
+                while (e < end && *e >= '0' && *e <= '9') {
+                    explicitExponent = explicitExponent * 10 + (*e - '0');
+                    ++e;
+                }
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                s = e;
+            }
+        }
+        double result = exponent == 0 ? mantissa : mantissa * std::pow(10.0, exponent);
+        value = static_cast<float>(negative ? -result : result);
+        p = s;
+        return true;
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    //  [begin, end)  "vertex" ͷУbeginend λ
+    bool parseAsciiLines(const char* begin, const char* end, std::vector<glm::vec3>& corners) {
+        const char* p = begin;
+        while (p < end) {
+            while (p < end && isSpace(*p)) ++p;
+            if (end - p > 6 && std::memcmp(p, "vertex", 6) == 0 && isSpace(p[6])) {
+                p += 6;
+                glm::vec3 corner;
+                for (int axis = 0; axis < 3; ++axis) {
+                    while (p < end && isSpace(*p)) ++p;
+                    if (!parseFloat(p, end, corner[axis])) {
+                        return false;
+                    }
+                }
+                corners.push_back(corner);
+            }
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            p = newline ? newline + 1 : end;
+        }
+        return true;
+    }
+
+    // ļгɴµȳ׿ʼɿ鲢нĽǵ㰴ļ˳ƴ
+    bool parseAscii(const char* data, size_t size, std::vector<glm::vec3>& corners, ThreadPool& pool) {
+        const size_t taskCount = (size + ASCII_BYTES_PER_TASK - 1) / ASCII_BYTES_PER_TASK;
+        auto lineStartAtOrAfter = [&](size_t offset) -> size_t {
+            if (offset == 0 || offset >= size) {
+                return (std::min)(offset, size);
+            }
+            if (data[offset - 1] == '\n') {
+                return offset;
+            }
+            const char* newline = static_cast<const char*>(std::memchr(data + offset, '\n', size - offset));
+            return newline ? static_cast<size_t>(newline - data) + 1 : size;
+        };
+
+        std::vector<std::vector<glm::vec3>> taskCorners(taskCount);
+        std::vector<char> taskFailed(taskCount, 0);
+        pool.parallelFor(taskCount, 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t task = begin; task < end; ++task) {
+                size_t first = lineStartAtOrAfter(task * ASCII_BYTES_PER_TASK);
+                size_t last = lineStartAtOrAfter((task + 1) * ASCII_BYTES_PER_TASK);
+                taskCorners[task].reserve((last - first) / 32);
+                if (!parseAsciiLines(data + first, data + last, taskCorners[task])) {
+                    taskFailed[task] = 1;
+                }
+            }
+        });
+
+        size_t total = 0;
+        for (size_t task = 0; task < taskCount; ++task) {
+            if (taskFailed[task]) {
+                return false;
+            }
+            total += taskCorners[task].size();
+        }
+        corners.clear();
+        corners.reserve(total);
+        for (const std::vector<glm::vec3>& part : taskCorners) {
+            corners.insert(corners.end(), part.begin(), part.end());
+        }
+        return true;
+    }
+
+    uint64_t hashPosition(const uint32_t bits[3]) {
+        uint64_t h = bits[0] * 0x9E3779B97F4A7C15ull;
+        h ^= bits[1] * 0xC2B2AE3D27D4EB4Full;
+        h ^= bits[2] * 0x165667B19E3779F9ull;
+        return h ^ (h >> 29);
+    }
+
+    // ÿѰַϣȫͬĽǵ㣨STL йĽǵֽظģ
+    // ɶÿεĵλۼӵϣȨͬ
+    void weldCorners(const std::vector<glm::vec3>& corners, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        size_t tableSize = 1;
+        while (tableSize < corners.size() * 2) {
+            tableSize <<= 1;
+        }
+        const uint64_t mask = tableSize - 1;
+        std::vector<uint32_t> slots(tableSize, EMPTY_SLOT);
+        std::vector<glm::vec3> positions;
+        positions.reserve(corners.size() / 4);
+        indices.resize(corners.size());
+
+        for (size_t i = 0; i < corners.size(); ++i) {
+            glm::vec3 position = corners[i] + glm::vec3(0.0f); // -0.0  0.0 Ϊͬһ
+            uint32_t bits[3];
+            std::memcpy(bits, &position, sizeof(bits));
+            uint64_t slot = hashPosition(bits) & mask;
+            for (;;) {
+                uint32_t id = slots[slot];
+                if (id == EMPTY_SLOT) {
+                    id = static_cast<uint32_t>(positions.size());
+                    positions.push_back(position);
+                    slots[slot] = id;
+                    indices[i] = id;
+                    break;
+                }
+                if (std::memcmp(&positions[id], bits, sizeof(bits)) == 0) {
+                    indices[i] = id;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        std::vector<glm::vec3> normals(positions.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const glm::vec3& a = positions[indices[i]];
+            const glm::vec3& b = positions[indices[i + 1]];
+            const glm::vec3& c = positions[indices[i + 2]];
+            glm::vec3 faceNormal = glm::cross(b - a, c - a);
+            float faceLength = glm::length(faceNormal);
+            if (faceLength <= 0.0f) {
+                continue; // ˻ûз
+            }
+            faceNormal /= faceLength;
+            normals[indices[i]] += faceNormal;
+            normals[indices[i + 1]] += faceNormal;
+            normals[indices[i + 2]] += faceNormal;
+        }
+
+        vertices.assign(positions.size(), Vertex{});
+        for (size_t v = 0; v < positions.size(); ++v) {
+            float length = glm::length(normals[v]);
+            vertices[v].Position = positions[v];
+            vertices[v].Normal = length > 0.0f ? normals[v] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            vertices[v].Color = glm::vec3(0.5f, 0.5f, 0.5f); //  Model ʱĬɫһ
+        }
+    }
+}
+
+bool StlLoader::load(const std::string& path, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) {
+        std::cout << "ERROR::STL_LOADER: failed to open " << path << std::endl;
+        return false;
+    }
+    const char* data = file.map(0, file.size());
+    if (!data) {
+        std::cout << "ERROR::STL_LOADER: failed to map " << path << std::endl;
+        return false;
+    }
+
+    ThreadPool pool;
+    std::vector<glm::vec3> corners;
+    uint32_t triangleCount = 0;
+    if (isBinaryStl(data, file.size(), triangleCount)) {
+        parseBinary(data, triangleCount, corners, pool);
+    } else if (!parseAscii(data, file.size(), corners, pool)) {
+        std::cout << "ERROR::STL_LOADER: malformed vertex in " << path << std::endl;
+        return false;
+    }
+    file.unmap();
+
+    if (corners.empty() || corners.size() % 3 != 0) {
+        std::cout << "ERROR::STL_LOADER: no complete triangles in " << path << std::endl;
+        return false;
+    }
+    weldCorners(corners, vertices, indices);
+    return true;
+}
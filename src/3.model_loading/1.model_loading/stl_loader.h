@@ -0,0 +1,18 @@
+#ifndef STL_LOADER_H
+#define STL_LOADER_H
+
+#include <string>
+#include <vector>
+#include <learnopengl/mesh.h> // For Vertex
+
+//  Assimp  STL ȡڴߴë
+// ļڴӳֿ鲢нΣASCIIʽ֧֣
+// ùϣȫͬĽǵ㺸Ϊͬһ㣬ȡελߵƽֵΪƽ
+//  aiProcess_GenSmoothNormals ͬȨֱΪ Mesh Ķ顣
+class StlLoader {
+public:
+    // ʧܣ޷򿪡ʽûΣʱ false
+    static bool load(const std::string& path, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
+
+#endif // STL_LOADER_H
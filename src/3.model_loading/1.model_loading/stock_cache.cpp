@@ -0,0 +1,161 @@
+#include "stock_cache.h"
+#include "Method.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    const char CACHE_MAGIC[8] = { 'M', 'I', 'L', 'L', 'C', 'A', 'C', 'H' };
+    const uint32_t CACHE_VERSION = 3;
+    // ݶΰ 8 ֽڶ
+    const uint64_t SECTION_ALIGNMENT = 8;
+
+    uint64_t alignSection(uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    bool sameParams(const StockCache::Params& a, const StockCache::Params& b) {
+        return a.surfaceYValue == b.surfaceYValue && a.surfaceYThreshold == b.surfaceYThreshold &&
+               a.quadtreeMaxLevels == b.quadtreeMaxLevels && a.quadtreeMaxVertsPerNode == b.quadtreeMaxVertsPerNode &&
+               std::strncmp(a.spatialIndex, b.spatialIndex, sizeof(a.spatialIndex)) == 0 && a.buildFlags == b.buildFlags;
+    }
+
+    // ݶ [offset, offset + count * elementSize) ǷļΧ
+    bool sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+    }
+}
+
+uint32_t StockCache::currentBuildFlags() {
+    uint32_t flags = 0;
+    if (ENABLE_HEIGHT_FIELD_STOCK) flags |= 1u << 0;
+    if (ENABLE_FAST_STL_LOADER) flags |= 1u << 4;
+    return flags;
+}
+
+void StockCache::setSpatialIndexName(Params& params, const std::string& name) {
+    std::memset(params.spatialIndex, 0, sizeof(params.spatialIndex));
+    std::strncpy(params.spatialIndex, name.c_str(), sizeof(params.spatialIndex) - 1);
+}
+
+std::string StockCache::cachePath(const std::string& inputPath) {
+    return inputPath + ".millcache";
+}
+
+bool StockCache::hashInput(const std::string& inputPath, uint64_t& size, uint64_t& hash) {
+    MappedFile input;
+    if (!input.open(inputPath)) {
+        return false;
+    }
+    size = input.size();
+    const char* data = size > 0 ? input.map(0, input.size()) : nullptr;
+    if (size > 0 && !data) {
+        return false;
+    }
+
+    //  8 ֽһ FNV-1aֽڿö࣬жļǷ仯Ѿ㹻
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+    hash = FNV_OFFSET_BASIS;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * FNV_PRIME;
+    }
+    return true;
+}
+
+bool StockCache::open(const std::string& inputPath, const Params& params) {
+    close();
+    uint64_t inputSize = 0, inputHash = 0;
+    file_ = std::make_unique<MappedFile>();
+    if (!file_->open(cachePath(inputPath)) || file_->size() < sizeof(Header) ||
+        !hashInput(inputPath, inputSize, inputHash)) {
+        close();
+        return false;
+    }
+    data_ = file_->map(0, file_->size());
+    if (!data_) {
+        close();
+        return false;
+    }
+    std::memcpy(&header_, data_, sizeof(Header));
+
+    const uint64_t fileSize = file_->size();
+    const bool valid = std::memcmp(header_.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+           header_.version == CACHE_VERSION &&
+           header_.vertexSize == sizeof(Vertex) &&
+           header_.inputSize == inputSize && header_.inputHash == inputHash &&
+           sameParams(header_.params, params) &&
+           header_.vertexCount > 0 &&
+           sectionFits(header_.vertexOffset, header_.vertexCount, sizeof(Vertex), fileSize) &&
+           sectionFits(header_.indexOffset, header_.indexCount, sizeof(unsigned int), fileSize) &&
+           sectionFits(header_.partitionOffset, header_.partitionSize, 1, fileSize);
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+void StockCache::close() {
+    file_.reset();
+    data_ = nullptr;
+}
+
+void StockCache::readMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) const {
+    // ʱᱻ޸ģĲҲָڲָ룬˿ֱʹӳڴ
+    const Vertex* vertexData = reinterpret_cast<const Vertex*>(data_ + header_.vertexOffset);
+    const unsigned int* indexData = reinterpret_cast<const unsigned int*>(data_ + header_.indexOffset);
+    vertices.assign(vertexData, vertexData + header_.vertexCount);
+    indices.assign(indexData, indexData + header_.indexCount);
+}
+
+bool StockCache::write(const std::string& inputPath, const Params& params,
+                       const Mesh& mesh, const std::vector<char>& spatialPartition) {
+    Header header;
+    std::memset(&header, 0, sizeof(header)); // ֽҲдļȷ
+    if (!hashInput(inputPath, header.inputSize, header.inputHash)) {
+        return false;
+    }
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.params = params;
+    header.vertexCount = mesh.vertices.size();
+    header.indexCount = mesh.indices.size();
+    header.partitionSize = spatialPartition.size();
+    header.vertexOffset = alignSection(sizeof(Header));
+    header.indexOffset = alignSection(header.vertexOffset + header.vertexCount * sizeof(Vertex));
+    header.partitionOffset = alignSection(header.indexOffset + header.indexCount * sizeof(unsigned int));
+
+    const std::string path = cachePath(inputPath);
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        const char padding[SECTION_ALIGNMENT] = {};
+        auto writeSection = [&](uint64_t offset, const void* data, uint64_t bytes) {
+            file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(file.tellp())));
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(header.vertexOffset, mesh.vertices.data(), header.vertexCount * sizeof(Vertex));
+        writeSection(header.indexOffset, mesh.indices.data(), header.indexCount * sizeof(unsigned int));
+        writeSection(header.partitionOffset, spatialPartition.data(), header.partitionSize);
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    // Windows  rename ܸļ
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
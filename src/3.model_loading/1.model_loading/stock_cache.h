@@ -0,0 +1,72 @@
+#ifndef STOCK_CACHE_H
+#define STOCK_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <learnopengl/mesh.h> // For Vertex / Mesh
+#include "mapped_file.h"
+
+// ëԤ棨ļһչΪ .millcacheӺĶ飬
+// ԼõĿռ MillingManager::serializeSpatialPartitionĿǰֻĲֻ֧棩
+// ڶʱڴӳ仺ļֱӿ鲢ָռӡ涥ɸѡͽ
+// ¼ļĴСݹϣVertex ĴС/ռԼ Method.h ӰĿأ
+// κһһ¶ΪδУɵɲǡ
+class StockCache {
+public:
+    struct Params {
+        float surfaceYValue;
+        float surfaceYThreshold;
+        int32_t quadtreeMaxLevels;
+        int32_t quadtreeMaxVertsPerNode;
+        char spatialIndex[24]; // ռƣ spatialIndexNames() 0 β
+        uint32_t buildFlags;   // currentBuildFlags()
+    };
+
+    //  Method.h ӰݵĿɣռ Params::spatialIndex ֣
+    static uint32_t currentBuildFlags();
+    //  name ضϺд params.spatialIndex
+    static void setSpatialIndexName(Params& params, const std::string& name);
+    static std::string cachePath(const std::string& inputPath);
+
+    //  inputPath ӦĻ棬治ڻļһʱ false
+    bool open(const std::string& inputPath, const Params& params);
+    // ӳ䲢رջļWindows ļӳʱܸǣ
+    void close();
+
+    // ֻ open ɹ
+    void readMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) const;
+    // ռݣûбռʱСΪ 0
+    const char* spatialPartitionData() const { return data_ + header_.partitionOffset; }
+    size_t spatialPartitionSize() const { return static_cast<size_t>(header_.partitionSize); }
+
+    // д뻺棨дʱļ滻джϲ²Ļ棩ʧʱ false
+    static bool write(const std::string& inputPath, const Params& params,
+                      const Mesh& mesh, const std::vector<char>& spatialPartition);
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexSize;
+        uint64_t inputSize;
+        uint64_t inputHash;
+        Params params;
+        uint64_t vertexOffset;
+        uint64_t vertexCount;
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        uint64_t partitionOffset;
+        uint64_t partitionSize;
+    };
+
+    // ڴӳļݹϣ޷ȡʱ false
+    static bool hashInput(const std::string& inputPath, uint64_t& size, uint64_t& hash);
+
+    std::unique_ptr<MappedFile> file_;
+    const char* data_ = nullptr;
+    Header header_ = {};
+};
+
+#endif // STOCK_CACHE_H
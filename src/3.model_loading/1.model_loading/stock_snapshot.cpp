@@ -0,0 +1,76 @@
+#include "stock_snapshot.h"
+
+#include <algorithm>
+
+StockSnapshotExchange::StockSnapshotExchange(const Model& simulationModel)
+    : consumedSequence_(0) {
+    for (const Mesh& mesh : simulationModel.meshes) {
+        size_t pages = (mesh.vertices.size() + Mesh::DIRTY_PAGE_VERTICES - 1) / Mesh::DIRTY_PAGE_VERTICES;
+        pageSequence_.emplace_back(pages, 0);
+    }
+}
+
+void StockSnapshotExchange::publish(Model& simulationModel) {
+    const uint64_t sequence = nextSequence_++;
+    const uint64_t consumed = consumedSequence_.load(std::memory_order_acquire);
+    StockSnapshot& snapshot = buffer_.writeBuffer();
+    snapshot.sequence = sequence;
+    snapshot.meshes.resize(simulationModel.meshes.size());
+
+    for (size_t m = 0; m < simulationModel.meshes.size(); ++m) {
+        Mesh& mesh = simulationModel.meshes[m];
+        std::vector<uint64_t>& pageSequence = pageSequence_[m];
+        mesh.forEachDirtyRange([&](size_t begin, size_t end) {
+            size_t lastPage = (end - 1) / Mesh::DIRTY_PAGE_VERTICES;
+            for (size_t page = begin / Mesh::DIRTY_PAGE_VERTICES; page <= lastPage; ++page) {
+                pageSequence[page] = sequence;
+            }
+        });
+        mesh.clearDirtyVertices();
+
+        // Ⱦ߳ȡߵİ汾֮޸ĹҳҪϣڵҳϲΪһ
+        StockSnapshot::MeshUpdate& update = snapshot.meshes[m];
+        update.ranges.clear();
+        update.vertices.clear();
+        const size_t pages = pageSequence.size();
+        size_t page = 0;
+        while (page < pages) {
+            if (pageSequence[page] <= consumed) {
+                ++page;
+                continue;
+            }
+            size_t firstPage = page;
+            while (page < pages && pageSequence[page] > consumed) {
+                ++page;
+            }
+            uint32_t begin = static_cast<uint32_t>(firstPage * Mesh::DIRTY_PAGE_VERTICES);
+            uint32_t end = static_cast<uint32_t>((std::min)(page * Mesh::DIRTY_PAGE_VERTICES, mesh.vertices.size()));
+            update.ranges.push_back({ begin, end });
+            update.vertices.insert(update.vertices.end(), mesh.vertices.begin() + begin, mesh.vertices.begin() + end);
+        }
+    }
+    buffer_.publish();
+}
+
+const StockSnapshot* StockSnapshotExchange::acquire() {
+    if (!buffer_.acquire()) {
+        return nullptr;
+    }
+    const StockSnapshot& snapshot = buffer_.readBuffer();
+    consumedSequence_.store(snapshot.sequence, std::memory_order_release);
+    return &snapshot;
+}
+
+void StockSnapshotExchange::apply(const StockSnapshot& snapshot, Model& renderModel) {
+    const size_t meshCount = (std::min)(snapshot.meshes.size(), renderModel.meshes.size());
+    for (size_t m = 0; m < meshCount; ++m) {
+        const StockSnapshot::MeshUpdate& update = snapshot.meshes[m];
+        Mesh& mesh = renderModel.meshes[m];
+        const Vertex* source = update.vertices.data();
+        for (const StockSnapshot::VertexRange& range : update.ranges) {
+            std::copy(source, source + (range.end - range.begin), mesh.vertices.begin() + range.begin);
+            mesh.markVerticesDirty(range.begin, range.end - range.begin);
+            source += range.end - range.begin;
+        }
+    }
+}
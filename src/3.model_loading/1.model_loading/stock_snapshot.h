@@ -0,0 +1,57 @@
+#ifndef STOCK_SNAPSHOT_H
+#define STOCK_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <learnopengl/model.h>
+#include "triple_buffer.h"
+
+// ̷߳Ⱦ̵߳һë״̬Ⱦ߳ϴȡ޸ĵĶ估ݣ
+// ԼҪëλõȡ
+struct StockSnapshot {
+    struct VertexRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+    struct MeshUpdate {
+        std::vector<VertexRange> ranges;
+        std::vector<Vertex> vertices; // Ķ
+    };
+
+    uint64_t sequence = 0;
+    std::vector<MeshUpdate> meshes;
+
+    glm::vec3 cubeWorldPosition{ 0.0f };
+    glm::vec3 appliedManualOffset{ 0.0f }; // ߳ѾӦõֶƶ
+    float traveledDistance = 0.0f;
+    bool pathActive = false;
+};
+
+// ߳Ⱦ֮߳ë״̬ݣ˫ȴԷ
+// ߳޸Լһ񸱱publish() ռҳȾ߳ acquire()  apply()
+// ޸дõȾ߳ԼϴԴ档
+// Ⱦ߳İ汾ᶪʧÿҳ¼һ޸ĵİ汾ţʱȾ߳δȡߵҳ
+class StockSnapshotExchange {
+public:
+    explicit StockSnapshotExchange(const Model& simulationModel);
+
+    // ̣߳ǰҪдĿգλõֶɵд
+    StockSnapshot& writeSnapshot() { return buffer_.writeBuffer(); }
+    // ̣߳ռ simulationModel ҳǣ޸ĹĶдպ󷢲
+    void publish(Model& simulationModel);
+
+    // Ⱦ̣߳ȡµĿգû¿ʱ nullptr
+    const StockSnapshot* acquire();
+    // Ⱦ̣߳ѿеĶд renderModel ҳλͼб
+    static void apply(const StockSnapshot& snapshot, Model& renderModel);
+
+private:
+    TripleBuffer<StockSnapshot> buffer_;
+    uint64_t nextSequence_ = 1;
+    std::atomic<uint64_t> consumedSequence_; // Ⱦ߳ȡߵİ汾
+    std::vector<std::vector<uint64_t>> pageSequence_; // [][ҳ] һ޸ʱİ汾
+};
+
+#endif // STOCK_SNAPSHOT_H
@@ -0,0 +1,91 @@
+#include "thread_pool.h"
+#include "frame_profiler.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned numThreads)
+    : body_(nullptr),
+      count_(0),
+      grainSize_(1),
+      nextIndex_(0),
+      activeWorkers_(0),
+      generation_(0),
+      stopping_(false) {
+    if (numThreads == 0) {
+        numThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    // ߳Ҳ㣬ֻٴ numThreads - 1 ߳
+    for (unsigned worker = 1; worker < numThreads; ++worker) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (std::thread& thread : workers_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const RangeFn& body) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = (std::max)(grainSize, size_t(1));
+    if (workers_.empty() || count <= grainSize) {
+        body(0, count, 0); // ֻһʱػѹ߳
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grainSize_ = grainSize;
+        nextIndex_.store(0);
+        activeWorkers_ = static_cast<unsigned>(workers_.size());
+        ++generation_;
+    }
+    wakeCondition_.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this] { return activeWorkers_ == 0; });
+    body_ = nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned worker) {
+    FrameProfiler::setThreadName("Milling Worker");
+    unsigned long long seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCondition_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--activeWorkers_ == 0) {
+            doneCondition_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks(unsigned worker) {
+    for (;;) {
+        size_t begin = nextIndex_.fetch_add(grainSize_);
+        if (begin >= count_) {
+            return;
+        }
+        (*body_)(begin, (std::min)(begin + grainSize_, count_), worker);
+    }
+}
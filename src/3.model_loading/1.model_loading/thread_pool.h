@@ -0,0 +1,51 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// פ̳߳أֻṩ parallelFor һ÷ [0, count) гɹ̶СĿ飬
+// ɹ̺߳͵߳һȡִУȫɺŷء
+// ͬһʱֻһ̵߳ parallelFor
+class ThreadPool {
+public:
+    // body(begin, end, worker)± [begin, end)worker Ϊ̵ִ߳ıţ߳Ϊ0
+    using RangeFn = std::function<void(size_t, size_t, unsigned)>;
+
+    // numThreads Ϊ̣߳߳0 ʾʹӲ߳
+    explicit ThreadPool(unsigned numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // ߳worker ŵȡֵΧΪ [0, size())
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    void parallelFor(size_t count, size_t grainSize, const RangeFn& body);
+
+private:
+    void workerLoop(unsigned worker);
+    void runChunks(unsigned worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable doneCondition_;
+
+    // ǰ mutex_ ·
+    const RangeFn* body_;
+    size_t count_;
+    size_t grainSize_;
+    std::atomic<size_t> nextIndex_; // һȡʼ±
+    unsigned activeWorkers_;        // ڴǰĹ߳
+    unsigned long long generation_; // ÿһ1ڻѹ߳
+    bool stopping_;
+};
+
+#endif // THREAD_POOL_H
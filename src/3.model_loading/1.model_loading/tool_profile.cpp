@@ -0,0 +1,36 @@
+#include "tool_profile.h"
+
+namespace {
+    struct ToolTypeName {
+        ToolType type;
+        const char* name;
+    };
+
+    const ToolTypeName TOOL_TYPE_NAMES[] = {
+        { ToolType::flat, "flat" },
+        { ToolType::ball, "ball" },
+        { ToolType::bullNose, "bull-nose" },
+        { ToolType::tapered, "tapered" },
+        { ToolType::chamfer, "chamfer" },
+        { ToolType::drill, "drill" },
+    };
+}
+
+bool parseToolType(const std::string& name, ToolType& type) {
+    for (const ToolTypeName& entry : TOOL_TYPE_NAMES) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* toolTypeName(ToolType type) {
+    for (const ToolTypeName& entry : TOOL_TYPE_NAMES) {
+        if (entry.type == type) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
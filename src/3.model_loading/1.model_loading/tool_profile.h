@@ -0,0 +1,97 @@
+#ifndef TOOL_PROFILE_H
+#define TOOL_PROFILE_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <glm/glm.hpp>
+
+enum ToolType
+{
+    flat,
+    ball,
+    bullNose, // ţǵԲǵƽ׵
+    tapered,  // ׶ͷͷ + ֮еԲ׶У
+    chamfer,  // ǵƽ׵ + Բ׶У
+    drill,    // ͷԲ׶⣩
+};
+
+// ƣflat / ball / bull-nose / tapered / chamfer / drillͣδ֪ʱ false
+bool parseToolType(const std::string& name, ToolType& type);
+const char* toolTypeName(ToolType type);
+
+// ߵ״߰뾶XZƽϵӰ췶Χ MillingManager 
+// ֻӦĵЧΪ APT  CutterProfile::aptParameters
+struct ToolShape {
+    ToolType type = ToolType::flat;
+    float cornerRadius = 0.0f;       // bullNose׽Բ뾶߰뾶ʱ߰뾶ͷ
+    float tipRadius = 0.0f;          // taperedͷ뾶chamferƽ׵İ뾶
+    float taperAngleDegrees = 45.0f; // tapered / chamfer뵶ļнǣȡֵ [1, 90] ȣ90 ʱˮƽ
+    float pointAngleDegrees = 118.0f; // drillⶥ
+};
+
+// ״ԣģMillingManagerHeightFieldStockʵÿֵ߸õһ
+// ѭѭвжϵ͡ƽ׵ͷʹĽʽ
+// ʹò CutterProfile cutter_profile.hµĲֻṩͬĳԱ
+//   radius                                  ߰뾶
+//   heightAt(distSquared)                   ൶ˮƽƽΪ distSquaredС radius^2±Եĸ߶
+//   normalAt(offset)                        гıķߣoffset ΪĶԵλ
+//   lowestAlong(slope, perpSq, halfChord)   бɨʱλã lowestAlongConvex
+
+// һ㵶ߵ lowestAlongĴӵͶӰλƶƫ u ʱõ߶Ϊ
+//   y(u) = slope * u + heightAt(perpSq + u^2)u  [-halfChord, halfChord]
+// heightAt 뵥Ϊ͹ʱ y(u) Ҳ͹ûƽָС
+template <typename Profile>
+float lowestAlongConvex(const Profile& profile, float slope, float perpDistSquared, float halfChord) {
+    const float INV_PHI = 0.618034f;
+    const int ITERATIONS = 30; // С halfChord  1e-6 
+    auto heightAlong = [&](float u) {
+        return slope * u + profile.heightAt((std::min)(perpDistSquared + u * u, profile.radius * profile.radius));
+    };
+    float lo = -halfChord;
+    float hi = halfChord;
+    float u1 = hi - INV_PHI * (hi - lo);
+    float u2 = lo + INV_PHI * (hi - lo);
+    float y1 = heightAlong(u1);
+    float y2 = heightAlong(u2);
+    for (int i = 0; i < ITERATIONS; ++i) {
+        if (y1 <= y2) {
+            hi = u2;
+            u2 = u1;
+            y2 = y1;
+            u1 = hi - INV_PHI * (hi - lo);
+            y1 = heightAlong(u1);
+        } else {
+            lo = u1;
+            u1 = u2;
+            y1 = y2;
+            u2 = lo + INV_PHI * (hi - lo);
+            y2 = heightAlong(u2);
+        }
+    }
+    return 0.5f * (lo + hi);
+}
+
+struct FlatToolProfile {
+    float radius;
+
+    float heightAt(float) const { return 0.0f; }
+    // ƽֱָϷ (Y)
+    glm::vec3 normalAt(const glm::vec3&) const { return glm::vec3(0.0f, 1.0f, 0.0f); }
+    // ߶Ⱦǵ߶ȣȡڵ͵һ
+    float lowestAlong(float slope, float, float halfChord) const { return (slope < 0.0f) ? halfChord : -halfChord; }
+};
+
+struct BallToolProfile {
+    float radius;
+
+    float heightAt(float distSquared) const { return radius - std::sqrt(radius * radius - distSquared); }
+    // Ǵָ򶥵λ
+    glm::vec3 normalAt(const glm::vec3& offset) const { return glm::normalize(offset - glm::vec3(0.0f, radius, 0.0f)); }
+    // y(u) = slope*u - sqrt(h^2 - u^2) ͹Ϊ0õС
+    float lowestAlong(float slope, float, float halfChord) const {
+        return -slope * halfChord / std::sqrt(1.0f + slope * slope);
+    }
+};
+
+#endif // TOOL_PROFILE_H
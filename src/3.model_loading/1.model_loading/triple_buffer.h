@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// 壺һд̡߳һ̡߳д߳һԼĻд
+// publish() м仺ԭӽ߳ acquire() ʱм仺µģͰ
+// ˫ȴԷ߳õ·Ļ壬м䱻ǵİ汾ᱻ
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle_(2), back_(0), front_(1) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // д̣߳ǰдĻ
+    T& writeBuffer() { return slots_[back_]; }
+
+    // д̣߳ writeBuffer()֮ writeBuffer() һ
+    void publish() {
+        unsigned previous = middle_.exchange(back_ | FRESH_BIT, std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+    }
+
+    // ̣߳·Ļʱ readBuffer()  true
+    bool acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        unsigned previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    // ̣߳һ acquire() õĻ
+    const T& readBuffer() const { return slots_[front_]; }
+
+private:
+    static constexpr unsigned INDEX_MASK = 3;
+    static constexpr unsigned FRESH_BIT = 4; // м仺巢δȡ
+
+    T slots_[3];
+    std::atomic<unsigned> middle_;
+    unsigned back_;  // ֻд̷߳
+    unsigned front_; // ֻɶ̷߳
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,179 @@
+#include "uniform_grid_index.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // build ÿ߳һμĶ
+    const size_t GRID_BUILD_GRAIN_SIZE = 8192;
+}
+
+UniformGridIndex::UniformGridIndex(glm::vec2 minBounds, glm::vec2 maxBounds, float cellSize)
+    : minBounds_(minBounds),
+      maxBounds_(maxBounds) {
+    glm::vec2 extent = glm::max(maxBounds - minBounds, glm::vec2(1e-6f));
+    float largestExtent = (std::max)(extent.x, extent.y);
+    cellSize_ = (std::max)(cellSize, largestExtent / MAX_CELLS_PER_AXIS);
+    inverseCellSize_ = 1.0f / cellSize_;
+    cellsX_ = (std::max)(1, static_cast<int>(std::ceil(extent.x * inverseCellSize_)));
+    cellsZ_ = (std::max)(1, static_cast<int>(std::ceil(extent.y * inverseCellSize_)));
+    cellsX_ = (std::min)(cellsX_, MAX_CELLS_PER_AXIS);
+    cellsZ_ = (std::min)(cellsZ_, MAX_CELLS_PER_AXIS);
+    cellOffsets_.assign(static_cast<size_t>(cellsX_) * cellsZ_ + 1, 0);
+}
+
+int UniformGridIndex::cellX(float x) const {
+    // ڸϽضϣԶ뷶ΧתΪʱ
+    float cell = (std::min)((std::max)((x - minBounds_.x) * inverseCellSize_, 0.0f), static_cast<float>(cellsX_ - 1));
+    return static_cast<int>(cell);
+}
+
+int UniformGridIndex::cellZ(float z) const {
+    float cell = (std::min)((std::max)((z - minBounds_.y) * inverseCellSize_, 0.0f), static_cast<float>(cellsZ_ - 1));
+    return static_cast<int>(cell);
+}
+
+void UniformGridIndex::bindMeshes(const std::vector<Mesh>& meshes) {
+    vertexIndexer_.bind(meshes);
+}
+
+void UniformGridIndex::resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const {
+    vertexIndexer_.resolve(globalIndex, meshIndex, vertexIndex);
+}
+
+void UniformGridIndex::build(const std::vector<Vertex*>& vertices, ThreadPool* pool) {
+    // 1. ÿڵĵԪ񣨿ɲУ Quadtree һ£Χ֮Ķ㱻
+    const uint32_t OUTSIDE = UINT32_MAX;
+    std::vector<uint32_t> cells(vertices.size());
+    auto classify = [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3& p = vertices[i]->Position;
+            bool inside = p.x >= minBounds_.x && p.x <= maxBounds_.x && p.z >= minBounds_.y && p.z <= maxBounds_.y;
+            cells[i] = inside ? static_cast<uint32_t>(cellZ(p.z)) * cellsX_ + cellX(p.x) : OUTSIDE;
+        }
+    };
+    if (pool) {
+        pool->parallelFor(vertices.size(), GRID_BUILD_GRAIN_SIZE, classify);
+    } else {
+        classify(0, vertices.size(), 0);
+    }
+
+    // 2. ͳÿԪĶǰ׺͵õʼλãٰԭ˳ַ
+    std::fill(cellOffsets_.begin(), cellOffsets_.end(), 0);
+    for (uint32_t cell : cells) {
+        if (cell != OUTSIDE) {
+            ++cellOffsets_[cell + 1];
+        }
+    }
+    for (size_t cell = 1; cell < cellOffsets_.size(); ++cell) {
+        cellOffsets_[cell] += cellOffsets_[cell - 1];
+    }
+    std::vector<uint32_t> next(cellOffsets_.begin(), cellOffsets_.end() - 1);
+    vertices_.assign(cellOffsets_.back(), nullptr);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (cells[i] != OUTSIDE) {
+            vertices_[next[cells[i]]++] = vertices[i];
+        }
+    }
+
+    // 3. SoA꣺ֻ޸ĶY꣬�XZʼЧ
+    points_.clear();
+    points_.reserve(vertices_.size());
+    for (Vertex* vertex : vertices_) {
+        uint32_t index = 0;
+        vertexIndexer_.indexOf(vertex, index);
+        points_.push_back(vertex->Position.x, vertex->Position.z, index);
+    }
+    points_.finalize();
+}
+
+template <typename VisitSpanFn>
+void UniformGridIndex::forEachSpan(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitSpanFn&& visitSpan) const {
+    if (vertices_.empty() || maxXZ.x < minBounds_.x || minXZ.x > maxBounds_.x ||
+        maxXZ.y < minBounds_.y || minXZ.y > maxBounds_.y) {
+        return;
+    }
+    // ĵԪʹͬĻ㣬굥˾ڵĶһ [x0, x1] x [z0, z1] 
+    const int x0 = cellX(minXZ.x), x1 = cellX(maxXZ.x);
+    const int z0 = cellZ(minXZ.y), z1 = cellZ(maxXZ.y);
+    for (int z = z0; z <= z1; ++z) {
+        const size_t rowStart = static_cast<size_t>(z) * cellsX_;
+        uint32_t begin = cellOffsets_[rowStart + x0];
+        uint32_t end = cellOffsets_[rowStart + x1 + 1];
+        if (begin < end) {
+            visitSpan(begin, end);
+        }
+    }
+}
+
+std::vector<Vertex*> UniformGridIndex::queryRange(const glm::vec2& center, float radius) const {
+    std::vector<Vertex*> resultVertices;
+    queryRange(center, radius, resultVertices);
+    return resultVertices;
+}
+
+std::vector<Vertex*> UniformGridIndex::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<Vertex*> resultVertices;
+    queryRect(minXZ, maxXZ, resultVertices);
+    return resultVertices;
+}
+
+std::vector<uint32_t> UniformGridIndex::queryRangeIndices(const glm::vec2& center, float radius) const {
+    std::vector<uint32_t> resultIndices;
+    queryRangeIndices(center, radius, resultIndices);
+    return resultIndices;
+}
+
+std::vector<uint32_t> UniformGridIndex::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const {
+    std::vector<uint32_t> resultIndices;
+    queryRectIndices(minXZ, maxXZ, resultIndices);
+    return resultIndices;
+}
+
+void UniformGridIndex::queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const {
+    visitRange(center, radius, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void UniformGridIndex::queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const {
+    visitRect(minXZ, maxXZ, [&](Vertex* vertex) { resultVertices.push_back(vertex); });
+}
+
+void UniformGridIndex::queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const {
+    const float radiusSq = radius * radius;
+    forEachSpan(center - glm::vec2(radius), center + glm::vec2(radius), [&](size_t begin, size_t end) {
+        SoaPointQuery::queryCircle(points_, begin, end, center, radiusSq, resultIndices);
+    });
+}
+
+void UniformGridIndex::queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const {
+    forEachSpan(minXZ, maxXZ, [&](size_t begin, size_t end) {
+        SoaPointQuery::queryRect(points_, begin, end, minXZ, maxXZ, resultIndices);
+    });
+}
+
+void UniformGridIndex::visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const {
+    const float radiusSq = radius * radius;
+    const float* xs = points_.xs.data();
+    const float* zs = points_.zs.data();
+    forEachSpan(center - glm::vec2(radius), center + glm::vec2(radius), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            float dx = xs[i] - center.x;
+            float dz = zs[i] - center.y;
+            if ((dx * dx + dz * dz) <= radiusSq) {
+                visitor(vertices_[i]);
+            }
+        }
+    });
+}
+
+void UniformGridIndex::visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const {
+    const float* xs = points_.xs.data();
+    const float* zs = points_.zs.data();
+    forEachSpan(minXZ, maxXZ, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (xs[i] >= minXZ.x && xs[i] <= maxXZ.x && zs[i] >= minXZ.y && zs[i] <= maxXZ.y) {
+                visitor(vertices_[i]);
+            }
+        }
+    });
+}
@@ -0,0 +1,75 @@
+#ifndef UNIFORM_GRID_INDEX_H
+#define UNIFORM_GRID_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <learnopengl/mesh.h> // For Vertex / Mesh
+#include "soa_point_query.h"
+#include "vertex_visitor.h"
+
+class ThreadPool;
+
+// ռXZƽ棩Ԫ߳ȡ߰뾶㰴ڵԪȣһУ
+// cellOffsets_ ΪԪʼλõǰ׺͡ѯʱֱǵĵԪΧ
+// ͬһڵĵԪһΣ뾶Ԫ߳Բา 3x3 Ԫ3 Ρ
+// ӿ Quadtree / LinearQuadtree Ĳѯһ£ھϸֵëûĵݹ鿪
+class UniformGridIndex {
+public:
+    // ԪޣÿᣩΧܴ cellSize СʱԶŴԪ
+    static constexpr int MAX_CELLS_PER_AXIS = 2048;
+
+    UniformGridIndex(glm::vec2 minBounds, glm::vec2 maxBounds, float cellSize);
+
+    // Ԫ verticesΧ֮Ķ㱻ԣ֮ǰݱ滻pool Ϊʱм
+    void build(const std::vector<Vertex*>& vertices, ThreadPool* pool);
+
+    // ѯԲཻĶ (XZƽ)
+    std::vector<Vertex*> queryRange(const glm::vec2& center, float radius) const;
+    // ѯڸڵĶ (XZƽ)
+    std::vector<Vertex*> queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // ѯԶŷأ MeshVertexIndexerҪ build ֮ǰ bindMeshes
+    std::vector<uint32_t> queryRangeIndices(const glm::vec2& center, float radius) const;
+    std::vector<uint32_t> queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ) const;
+
+    // ѽ׷ӵߵĩβգ Quadtree еͬ
+    void queryRange(const glm::vec2& center, float radius, std::vector<Vertex*>& resultVertices) const;
+    void queryRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<Vertex*>& resultVertices) const;
+    void queryRangeIndices(const glm::vec2& center, float radius, std::vector<uint32_t>& resultIndices) const;
+    void queryRectIndices(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<uint32_t>& resultIndices) const;
+
+    // صʽĲѯ ISpatialIndex
+    void visitRange(const glm::vec2& center, float radius, VertexVisitor visitor) const;
+    void visitRect(const glm::vec2& minXZ, const glm::vec2& maxXZ, VertexVisitor visitor) const;
+
+    void bindMeshes(const std::vector<Mesh>& meshes);
+    void resolveIndex(uint32_t globalIndex, uint32_t& meshIndex, uint32_t& vertexIndex) const;
+
+    int getCellsX() const { return cellsX_; }
+    int getCellsZ() const { return cellsZ_; }
+    float getCellSize() const { return cellSize_; }
+    size_t size() const { return vertices_.size(); }
+
+private:
+    // ڵĵԪ񣬳Χʱضϵ߽ϵĵԪ
+    int cellX(float x) const;
+    int cellZ(float z) const;
+    // ԾθǵÿһеԪ± [begin, end) ص visitSpan
+    template <typename VisitSpanFn>
+    void forEachSpan(const glm::vec2& minXZ, const glm::vec2& maxXZ, VisitSpanFn&& visitSpan) const;
+
+    glm::vec2 minBounds_;
+    glm::vec2 maxBounds_;
+    float cellSize_;
+    float inverseCellSize_;
+    int cellsX_;
+    int cellsZ_;
+
+    std::vector<uint32_t> cellOffsets_; // ΪԪ + 1
+    std::vector<Vertex*> vertices_;     // ԪĶ
+    SoaPoints points_;                  //  vertices_ һһӦXZͶ
+    MeshVertexIndexer vertexIndexer_;
+};
+
+#endif // UNIFORM_GRID_INDEX_H
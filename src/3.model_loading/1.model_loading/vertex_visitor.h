@@ -0,0 +1,24 @@
+#ifndef VERTEX_VISITOR_H
+#define VERTEX_VISITOR_H
+
+#include <type_traits>
+#include <learnopengl/mesh.h> // For Vertex struct
+
+// ѯصֻɵöĵַһת͵öڴ档
+// ɵöڲѯڼЧֱӰ lambda Ϊ visitRange / visitRect ɣ
+class VertexVisitor {
+public:
+    template <typename Fn,
+              typename = typename std::enable_if<!std::is_same<typename std::decay<Fn>::type, VertexVisitor>::value>::type>
+    VertexVisitor(Fn&& fn)
+        : context_(const_cast<void*>(static_cast<const void*>(&fn))),
+          invoke_([](void* context, Vertex* vertex) { (*static_cast<typename std::remove_reference<Fn>::type*>(context))(vertex); }) {}
+
+    void operator()(Vertex* vertex) const { invoke_(context_, vertex); }
+
+private:
+    void* context_;
+    void (*invoke_)(void* context, Vertex* vertex);
+};
+
+#endif // VERTEX_VISITOR_H